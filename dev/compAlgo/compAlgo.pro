@@ -9,6 +9,8 @@ QMAKE_CXXFLAGS += -std=c++11
 LIBS += -lgsl
 LIBS += -lgslcblas
 LIBS += -lm
+LIBS += -pthread
+LIBS += -lz
 
 CONFIG(debug, debug | release) {
 	CONFIGURATION = debug
@@ -23,6 +25,27 @@ DESTDIR = $$PWD/build/$$CONFIGURATION/bin/
 SOURCES += src/main.cpp \
     src/simulator.cpp \
     src/helpers.cpp \
+    src/sim-context.cpp \
+    src/timer-service.cpp \
+    src/memory-arena.cpp \
+    src/event-queue.cpp \
+    src/trace-cursor.cpp \
+    src/mapped-file.cpp \
+    src/field-scanner.cpp \
+    src/columnar-trace.cpp \
+    src/trace-index.cpp \
+    src/trace-fingerprint.cpp \
+    src/pipelined-trace-cursor.cpp \
+    src/parallel-trace-cursor.cpp \
+    src/gzip-trace-cursor.cpp \
+    src/decimating-trace-cursor.cpp \
+    src/trace-buffer.cpp \
+    src/output-writer.cpp \
+    src/rlc-line-table.cpp \
+    src/line-reader.cpp \
+    src/packet-selection.cpp \
+    src/sweep-runner.cpp \
+    src/partitioned-simulator.cpp \
     src/lteEnb/l2-mac.cpp \
     src/lteEnb/x2-channel.cpp \
     src/lteEnb/ff-mac-scheduler.cpp \
@@ -36,7 +59,30 @@ SOURCES += src/main.cpp \
 
 HEADERS += \
     src/helpers.h \
+    src/checkpoint.h \
     src/simulator.h \
+    src/sim-context.h \
+    src/timer-service.h \
+    src/memory-arena.h \
+    src/event-queue.h \
+    src/trace-cursor.h \
+    src/mapped-file.h \
+    src/field-scanner.h \
+    src/columnar-trace.h \
+    src/trace-index.h \
+    src/trace-fingerprint.h \
+    src/spsc-ring.h \
+    src/pipelined-trace-cursor.h \
+    src/parallel-trace-cursor.h \
+    src/gzip-trace-cursor.h \
+    src/decimating-trace-cursor.h \
+    src/trace-buffer.h \
+    src/output-writer.h \
+    src/rlc-line-table.h \
+    src/line-reader.h \
+    src/packet-selection.h \
+    src/sweep-runner.h \
+    src/partitioned-simulator.h \
     src/messages.h \
     src/lteEnb/l2-mac.h \
     src/lteEnb/x2-channel.h \
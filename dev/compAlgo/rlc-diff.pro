@@ -0,0 +1,31 @@
+TEMPLATE = app
+TARGET = rlc-diff
+CONFIG += console
+CONFIG -= app_bundle
+CONFIG -= qt
+
+QMAKE_CXXFLAGS += -std=c++11
+
+LIBS += -pthread
+LIBS += -lz
+
+CONFIG(debug, debug | release) {
+	CONFIGURATION = debug
+} else {
+	CONFIGURATION = release
+}
+
+OBJECTS_DIR = $$PWD/build/$$CONFIGURATION/rlc-diff/obj
+MOC_DIR = $$PWD/build/$$CONFIGURATION/rlc-diff/moc
+DESTDIR = $$PWD/build/$$CONFIGURATION/bin/
+
+SOURCES += src/tools/rlc-diff.cpp \
+    src/helpers.cpp \
+    src/field-scanner.cpp \
+    src/line-reader.cpp
+
+HEADERS += \
+    src/helpers.h \
+    src/checkpoint.h \
+    src/field-scanner.h \
+    src/line-reader.h
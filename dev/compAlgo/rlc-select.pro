@@ -0,0 +1,51 @@
+TEMPLATE = app
+TARGET = rlc-select
+CONFIG += console
+CONFIG -= app_bundle
+CONFIG -= qt
+
+QMAKE_CXXFLAGS += -std=c++11
+
+LIBS += -pthread
+LIBS += -lz
+
+CONFIG(debug, debug | release) {
+	CONFIGURATION = debug
+} else {
+	CONFIGURATION = release
+}
+
+OBJECTS_DIR = $$PWD/build/$$CONFIGURATION/rlc-select/obj
+MOC_DIR = $$PWD/build/$$CONFIGURATION/rlc-select/moc
+DESTDIR = $$PWD/build/$$CONFIGURATION/bin/
+
+SOURCES += src/tools/rlc-select.cpp \
+    src/helpers.cpp \
+    src/trace-cursor.cpp \
+    src/trace-index.cpp \
+    src/trace-fingerprint.cpp \
+    src/mapped-file.cpp \
+    src/field-scanner.cpp \
+    src/columnar-trace.cpp \
+    src/parallel-trace-cursor.cpp \
+    src/gzip-trace-cursor.cpp \
+    src/decimating-trace-cursor.cpp \
+    src/rlc-line-table.cpp \
+    src/line-reader.cpp \
+    src/packet-selection.cpp
+
+HEADERS += \
+    src/helpers.h \
+    src/checkpoint.h \
+    src/trace-cursor.h \
+    src/trace-index.h \
+    src/trace-fingerprint.h \
+    src/mapped-file.h \
+    src/field-scanner.h \
+    src/columnar-trace.h \
+    src/parallel-trace-cursor.h \
+    src/gzip-trace-cursor.h \
+    src/decimating-trace-cursor.h \
+    src/rlc-line-table.h \
+    src/line-reader.h \
+    src/packet-selection.h
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <cstdint>
+#include <vector>
+#include <deque>
+#include <queue>
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <type_traits>
+
+//! @class CheckpointWriter puts the simulation state to a binary stream, see Simulator::setCheckpoint
+//! @note the format is host dependent, checkpoints are not meant to move between machines
+class CheckpointWriter
+{
+public:
+  explicit CheckpointWriter(std::ostream &stream) : mStream(stream) {}
+
+  bool good() const { return mStream.good(); }
+
+  template <typename T>
+  typename std::enable_if<std::is_trivially_copyable<T>::value>::type write(const T &value)
+  {
+    mStream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  void write(const std::string &value)
+  {
+    write(value.size());
+    mStream.write(value.data(), value.size());
+  }
+
+  template <typename T, typename U>
+  void write(const std::pair<T, U> &value)
+  {
+    write(value.first);
+    write(value.second);
+  }
+
+  template <typename T, typename A>
+  void write(const std::vector<T, A> &values) { writeRange(values); }
+
+  template <typename T, typename A>
+  void write(const std::deque<T, A> &values) { writeRange(values); }
+
+  template <typename T>
+  void write(std::queue<T> values)
+  {
+    write(values.size());
+    for (; !values.empty(); values.pop())
+      write(values.front());
+  }
+
+  template <typename K, typename V, typename C, typename A>
+  void write(const std::map<K, V, C, A> &values) { writeRange(values); }
+
+  //! @note the order of the elements is the one of the writing process, it does not affect lookups
+  template <typename K, typename V>
+  void write(const std::unordered_map<K, V> &values) { writeRange(values); }
+
+private:
+  std::ostream &mStream;
+
+  template <typename C>
+  void writeRange(const C &values)
+  {
+    write(values.size());
+    for (const auto &value : values)
+      write(value);
+  }
+};
+
+
+//! @class CheckpointReader takes the state back in the order CheckpointWriter has put it
+//! @brief a container cannot have more elements than the rest of the stream can hold,
+//!  a broken or forged size fails the reader instead of allocating the memory
+class CheckpointReader
+{
+public:
+  explicit CheckpointReader(std::istream &stream) : mStream(stream), mEnd(endOf(stream)) {}
+
+  bool good() const { return mStream.good(); }
+
+  template <typename T>
+  typename std::enable_if<std::is_trivially_copyable<T>::value>::type read(T &value)
+  {
+    mStream.read(reinterpret_cast<char*>(&value), sizeof(T));
+  }
+
+  void read(std::string &value)
+  {
+    value.resize(readSize(1));
+    mStream.read(&value[0], value.size());
+  }
+
+  template <typename T, typename U>
+  void read(std::pair<T, U> &value)
+  {
+    read(value.first);
+    read(value.second);
+  }
+
+  //! @note the containers keep their allocators
+  template <typename T, typename A>
+  void read(std::vector<T, A> &values) { readSequence(values); }
+
+  template <typename T, typename A>
+  void read(std::deque<T, A> &values) { readSequence(values); }
+
+  template <typename T>
+  void read(std::queue<T> &values)
+  {
+    std::deque<T> sequence;
+    readSequence(sequence);
+    values = std::queue<T>(std::move(sequence));
+  }
+
+  template <typename K, typename V, typename C, typename A>
+  void read(std::map<K, V, C, A> &values) { readMap(values); }
+
+  template <typename K, typename V>
+  void read(std::unordered_map<K, V> &values) { readMap(values); }
+
+private:
+  //! @brief limit of the stored size if the stream cannot tell its length
+  static constexpr uint64_t unseekableSize = uint64_t(1) << 30;
+
+  std::istream &mStream;
+  const std::streamoff mEnd; //< negative if the stream cannot seek
+
+  static std::streamoff endOf(std::istream &stream)
+  {
+    const std::streamoff position = stream.tellg();
+    if (position < 0)
+      return -1;
+    stream.seekg(0, std::ios_base::end);
+    const std::streamoff end = stream.tellg();
+    stream.seekg(position);
+    return end;
+  }
+
+  //! @brief the minimal stored size of an element, the trivially copyable ones are stored as they are
+  template <typename T>
+  static constexpr size_t storedSize() { return std::is_trivially_copyable<T>::value ? sizeof(T) : 1; }
+
+  //! @arg elementSize minimal stored size of an element
+  size_t readSize(size_t elementSize)
+  {
+    size_t size = 0;
+    read(size);
+    const std::streamoff position = mStream.tellg();
+    uint64_t restSize = unseekableSize;
+    if (mEnd >= 0 && position >= 0)
+      restSize = position < mEnd ? mEnd - position : 0;
+    if (size > restSize / elementSize)
+      mStream.setstate(std::ios_base::failbit);
+    return good() ? size : 0;
+  }
+
+  template <typename C>
+  void readSequence(C &values)
+  {
+    values.clear();
+    values.resize(readSize(storedSize<typename C::value_type>()));
+    for (auto &value : values)
+      read(value);
+  }
+
+  template <typename M>
+  void readMap(M &values)
+  {
+    values.clear();
+    for (size_t i = readSize(storedSize<typename M::key_type>() + storedSize<typename M::mapped_type>()); i > 0; --i)
+      {
+        std::pair<typename M::key_type, typename M::mapped_type> value;
+        read(value);
+        values.insert(std::move(value));
+      }
+  }
+};
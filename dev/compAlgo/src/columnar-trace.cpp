@@ -0,0 +1,200 @@
+#include "columnar-trace.h"
+
+#include <cstring>
+#include <fstream>
+#include <algorithm>
+#include <sys/stat.h>
+
+namespace
+{
+  const char *const columnarSignature = "compAlgo columnar trace";
+
+  size_t columnsCountOf(TraceKind kind)
+  {
+    return kind == TraceKind::rlcStats ? size_t(ColumnarTrace::RlcColumn::count)
+                                       : size_t(ColumnarTrace::MeasurementColumn::count);
+  }
+
+  //! @brief element sizes of the columns in their order
+  std::vector<size_t> elementSizesOf(TraceKind kind)
+  {
+    if (kind == TraceKind::rlcStats)
+      return {sizeof(Time), sizeof(Time), sizeof(int32_t), sizeof(int32_t), sizeof(int32_t), sizeof(int32_t),
+              sizeof(int32_t), sizeof(uint64_t), sizeof(uint64_t), sizeof(char)};
+    return {sizeof(Time), sizeof(int32_t), sizeof(int32_t), sizeof(int32_t)};
+  }
+
+  uint64_t aligned(uint64_t offset)
+  {
+    return (offset + ColumnarTrace::columnAlignment - 1) / ColumnarTrace::columnAlignment
+        * ColumnarTrace::columnAlignment;
+  }
+}
+
+constexpr uint32_t ColumnarTrace::formatVersion;
+constexpr size_t ColumnarTrace::columnAlignment;
+constexpr size_t ColumnarTrace::maxColumnsCount;
+
+ColumnarTrace::ColumnarTrace(const std::string &location)
+  : mFile(location)
+{
+}
+
+bool ColumnarTrace::isValid(TraceKind kind) const
+{
+  if (!mFile.isOpen() || mFile.size() < sizeof(Header))
+    return false;
+
+  const Header &info = header();
+  if (strncmp(info.signature, columnarSignature, sizeof(info.signature)) || info.version != formatVersion
+      || info.kind != kind || info.columnsCount != columnsCountOf(kind))
+    return false;
+
+  const std::vector<size_t> elementSizes = elementSizesOf(kind);
+  for (size_t i = 0; i < info.columnsCount; ++i)
+    {
+      const uint64_t offset = info.columnOffsets[i];
+      const uint64_t size = info.columnSizes[i];
+      if (offset % columnAlignment || offset > mFile.size() || size > mFile.size() - offset)
+        return false;
+      // the lines are the only column of another length
+      const bool isLines = kind == TraceKind::rlcStats && i == size_t(RlcColumn::lines);
+      if (!isLines && size != info.rowsCount * elementSizes[i])
+        return false;
+    }
+
+  if (kind == TraceKind::rlcStats)
+    {
+      const uint64_t linesSize = info.columnSizes[size_t(RlcColumn::lines)];
+      if (info.rowsCount && (!linesSize || column<char>(RlcColumn::lines)[linesSize - 1] != '\0'))
+        return false;
+
+      // the line numbers are searched by RlcLineTable and the offsets are read from, a corrupt file must not pass
+      const uint64_t *lineNumbers = column<uint64_t>(RlcColumn::lineNumber);
+      const uint64_t *lineOffsets = column<uint64_t>(RlcColumn::lineOffset);
+      for (uint64_t row = 0; row < info.rowsCount; ++row)
+        {
+          if (lineNumbers[row] >= info.sourceSize || (row && lineNumbers[row] <= lineNumbers[row - 1])
+              || lineOffsets[row] >= linesSize)
+            return false;
+        }
+    }
+  return true;
+}
+
+
+ColumnarTraceWriter::ColumnarTraceWriter(TraceKind kind, const TraceFingerprint &source, uint64_t rowsCount)
+  : mKind(kind)
+  , mSource(source)
+  , mRowsCount(rowsCount)
+{
+}
+
+bool ColumnarTraceWriter::save(const std::string &location) const
+{
+  assert(mColumns.size() == columnsCountOf(mKind));
+
+  ColumnarTrace::Header header;
+  memset(&header, 0, sizeof(header));
+  strncpy(header.signature, columnarSignature, sizeof(header.signature));
+  header.version = ColumnarTrace::formatVersion;
+  header.kind = mKind;
+  header.sourceSize = mSource.size;
+  header.sourceModifiedTime = mSource.modifiedTime;
+  header.sourceHash = mSource.hash;
+  header.rowsCount = mRowsCount;
+  header.columnsCount = mColumns.size();
+
+  uint64_t offset = aligned(sizeof(header));
+  for (size_t i = 0; i < mColumns.size(); ++i)
+    {
+      header.columnOffsets[i] = offset;
+      header.columnSizes[i] = mColumns[i].second;
+      offset = aligned(offset + mColumns[i].second);
+    }
+
+  std::fstream file(location, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+  if (!file.is_open())
+    return false;
+
+  const char padding[ColumnarTrace::columnAlignment] = {};
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  uint64_t written = sizeof(header);
+  for (size_t i = 0; i < mColumns.size(); ++i)
+    {
+      file.write(padding, header.columnOffsets[i] - written);
+      file.write(static_cast<const char*>(mColumns[i].first), mColumns[i].second);
+      written = header.columnOffsets[i] + mColumns[i].second;
+    }
+  file.flush();
+  return file.good();
+}
+
+
+ColumnarTraceCursor::ColumnarTraceCursor(const std::string &location, TraceKind kind)
+  : mTrace(location)
+  , mKind(kind)
+  , mIsValid(mTrace.isValid(kind))
+  , mRowsCount(mIsValid ? mTrace.rowsCount() : 0)
+  // both kinds start with the event times
+  , mTimes(mIsValid ? mTrace.column<Time>(ColumnarTrace::RlcColumn::startTime) : nullptr)
+{
+}
+
+bool ColumnarTraceCursor::isConvertedFrom(const std::string &traceLocation) const
+{
+  struct stat info;
+  if (stat(traceLocation.c_str(), &info))
+    return true;
+
+  TraceFingerprint trace;
+  const ColumnarTrace::Header &header = mTrace.header();
+  return TraceFingerprint::of(traceLocation, trace) && trace.size == header.sourceSize
+      && trace.modifiedTime == header.sourceModifiedTime && trace.hash == header.sourceHash;
+}
+
+void ColumnarTraceCursor::seek(Time from)
+{
+  mRow = std::lower_bound(mTimes, mTimes + mRowsCount, from) - mTimes;
+  mHasFront = false;
+}
+
+const Event &ColumnarTraceCursor::front()
+{
+  assert(!empty());
+  if (mHasFront)
+    return mFront;
+
+  using RlcColumn = ColumnarTrace::RlcColumn;
+  using MeasurementColumn = ColumnarTrace::MeasurementColumn;
+  if (mKind == TraceKind::rlcStats)
+    {
+      RlcRecord record;
+      record.startTime = mTimes[mRow];
+      record.endTime = mTrace.column<Time>(RlcColumn::endTime)[mRow];
+      record.cellId = mTrace.column<int32_t>(RlcColumn::cellId)[mRow];
+      record.imsi = mTrace.column<int32_t>(RlcColumn::imsi)[mRow];
+      record.rnti = mTrace.column<int32_t>(RlcColumn::rnti)[mRow];
+      record.txBytes = mTrace.column<int32_t>(RlcColumn::txBytes)[mRow];
+      record.rxBytes = mTrace.column<int32_t>(RlcColumn::rxBytes)[mRow];
+      mFront = eventOf(record, mTrace.column<uint64_t>(RlcColumn::lineNumber)[mRow]);
+    }
+  else
+    {
+      MeasurementRecord record;
+      record.time = mTimes[mRow];
+      record.sourceCellId = mTrace.column<int32_t>(MeasurementColumn::sourceCellId)[mRow];
+      record.targetCellId = mTrace.column<int32_t>(MeasurementColumn::targetCellId)[mRow];
+      record.rsrp = mTrace.column<int32_t>(MeasurementColumn::rsrp)[mRow];
+      mFront = eventOf(record);
+    }
+  mHasFront = true;
+  return mFront;
+}
+
+void ColumnarTraceCursor::pop()
+{
+  assert(!empty());
+  ++mRow;
+  mHasFront = false;
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "trace-cursor.h"
+#include "mapped-file.h"
+#include "trace-fingerprint.h"
+
+//! @class ColumnarTrace is the binary columnar copy of a text trace, made by trace-convert as "<trace>.col"
+//! @brief every field is a contiguous aligned array, so the file is mapped and used as is by the simulation
+//!  or by vectorized post-processing. Only the rows the simulation takes are kept, the RLC lines are kept
+//!  NUL-terminated for RlcLineTable if there is no text trace. The columns follow the Header in the order of RlcColumn or MeasurementColumn.
+//! @note the format is host dependent like the checkpoints
+class ColumnarTrace
+{
+public:
+  static constexpr uint32_t formatVersion = 3;
+  static constexpr size_t columnAlignment = 64;
+  static constexpr size_t maxColumnsCount = 16;
+
+  enum class RlcColumn : uint32_t
+  {
+    startTime,   //< Time
+    endTime,     //< Time
+    cellId,      //< int32_t
+    imsi,        //< int32_t
+    rnti,        //< int32_t
+    txBytes,     //< int32_t
+    rxBytes,     //< int32_t
+    lineNumber,  //< uint64_t after the header of the text trace, DlRlcPacket::index
+    lineOffset,  //< uint64_t in lines
+    lines,       //< char, NUL-terminated lines of the text trace
+    count
+  };
+
+  enum class MeasurementColumn : uint32_t
+  {
+    time,          //< Time
+    sourceCellId,  //< int32_t
+    targetCellId,  //< int32_t
+    rsrp,          //< int32_t
+    count
+  };
+
+  struct Header
+  {
+    char signature[24];
+    uint32_t version;
+    TraceKind kind;
+    uint64_t sourceSize;          //< TraceFingerprint of the text trace, a copy of another one is not used
+    int64_t sourceModifiedTime;
+    uint64_t sourceHash;
+    uint64_t rowsCount;
+    uint32_t columnsCount;
+    uint32_t reserved;
+    uint64_t columnOffsets[maxColumnsCount];
+    uint64_t columnSizes[maxColumnsCount];  //< in bytes
+  };
+
+  static std::string locationOf(const std::string &traceLocation) { return traceLocation + ".col"; }
+
+  explicit ColumnarTrace(const std::string &location);
+
+  //! @return false if there is no file or it is not a columnar trace of the kind and version,
+  //!  or its line numbers and offsets are out of the trace
+  bool isValid(TraceKind kind) const;
+
+  const Header& header() const { return *reinterpret_cast<const Header*>(mFile.data()); }
+  size_t rowsCount() const { return header().rowsCount; }
+
+  template <typename T, typename Column>
+  const T* column(Column index) const
+  {
+    return reinterpret_cast<const T*>(mFile.data() + header().columnOffsets[size_t(index)]);
+  }
+
+private:
+  MappedFile mFile;
+
+  ColumnarTrace(const ColumnarTrace &) = delete;
+  ColumnarTrace& operator =(const ColumnarTrace &) = delete;
+};
+
+
+//! @class ColumnarTraceWriter puts the columns of a trace to a ColumnarTrace file
+class ColumnarTraceWriter
+{
+public:
+  ColumnarTraceWriter(TraceKind kind, const TraceFingerprint &source, uint64_t rowsCount);
+
+  //! @note the columns are added in the order of the kind, they are not copied
+  template <typename T>
+  void addColumn(const std::vector<T> &values) { mColumns.emplace_back(values.data(), values.size() * sizeof(T)); }
+
+  bool save(const std::string &location) const;
+
+private:
+  const TraceKind mKind;
+  const TraceFingerprint mSource;
+  const uint64_t mRowsCount;
+  std::vector<std::pair<const void*, size_t>> mColumns;
+};
+
+
+//! @class ColumnarTraceCursor reads the events right from the mapped ColumnarTrace
+class ColumnarTraceCursor : public ITraceCursor
+{
+public:
+  ColumnarTraceCursor(const std::string &location, TraceKind kind);
+
+  bool isValid() const { return mIsValid; }
+  //! @return true if the trace is converted from the current text trace or the text trace is absent
+  bool isConvertedFrom(const std::string &traceLocation) const;
+
+  //! @brief skips to the first event at or after the time by a binary search in the times
+  void seek(Time from);
+
+  bool empty() override { return mRow == mRowsCount; }
+  const Event& front() override;
+  void pop() override;
+
+private:
+  ColumnarTrace mTrace;
+  const TraceKind mKind;
+  const bool mIsValid;
+  const size_t mRowsCount;
+  const Time *mTimes;
+  size_t mRow = 0;
+  Event mFront;
+  bool mHasFront = false;
+
+  ColumnarTraceCursor(const ColumnarTraceCursor &) = delete;
+  ColumnarTraceCursor& operator =(const ColumnarTraceCursor &) = delete;
+};
@@ -0,0 +1,63 @@
+#include "decimating-trace-cursor.h"
+
+#include <assert.h>
+
+static_assert(SimConfig::timeInterval % SimConfig::traceInterval == 0,
+              "the measurements period must be a multiple of the one of the traces");
+
+DecimatingTraceCursor::DecimatingTraceCursor(UniqTraceCursor source, Time tracePeriod, Time period)
+  : mSource(std::move(source))
+  , mTracePeriod(tracePeriod)
+  , mRatio(period / tracePeriod)
+{
+  assert(tracePeriod > 0 && period % tracePeriod == 0);
+}
+
+UniqTraceCursor DecimatingTraceCursor::decimate(UniqTraceCursor source)
+{
+  if (SimConfig::traceInterval == SimConfig::timeInterval)
+    return source;
+
+  LOG("measurements are decimated from " << SimConfig::traceInterval << " to " << SimConfig::timeInterval << " [ms]");
+  return UniqTraceCursor(new DecimatingTraceCursor(std::move(source), Converter::milliseconds(SimConfig::traceInterval),
+                                                   Converter::milliseconds(SimConfig::timeInterval)));
+}
+
+bool DecimatingTraceCursor::empty()
+{
+  skipDropped();
+  return mSource->empty();
+}
+
+const Event &DecimatingTraceCursor::front()
+{
+  skipDropped();
+  return mSource->front();
+}
+
+void DecimatingTraceCursor::pop()
+{
+  popFront();
+}
+
+void DecimatingTraceCursor::skipDropped()
+{
+  while (!mSource->empty() && (mSource->front().atTime / mTracePeriod) % mRatio)
+    popFront();
+}
+
+void DecimatingTraceCursor::popFront()
+{
+  const Event &report = mSource->front();
+  const Time period = report.atTime / mTracePeriod;
+  auto last = mLastPeriods.insert(std::make_pair(std::make_pair(report.cellId, report.report.targetCellId), period));
+  if (!last.second && last.first->second >= period && !mIsDelayWarned)
+    {
+      WARN("two reports of cell " << report.cellId << " about cell " << report.report.targetCellId
+           << " in the period of " << report.atTime << " [us]: the delay reaches the trace period, "
+           << "the decimated reports may be from the wrong periods");
+      mIsDelayWarned = true;
+    }
+  last.first->second = period;
+  mSource->pop();
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <map>
+
+#include "trace-cursor.h"
+
+//! @class DecimatingTraceCursor resamples a CSI trace to a coarser reporting period
+//! @brief the reports of a period are at its start plus the delay of the source cell, so the period of a report
+//!  is its time divided by the trace period. A coarser run reports in every N-th period of the finer one
+//!  from the start, only the reports of those periods are passed through.
+//! @note the rule holds while the delays are shorter than the trace period: a later report would fall
+//!  into the next period, which then has two reports of the cell about the same target. That is warned about.
+class DecimatingTraceCursor : public ITraceCursor
+{
+public:
+  //! @arg source measurements of every tracePeriod
+  //! @arg period coarser reporting period, a multiple of tracePeriod
+  DecimatingTraceCursor(UniqTraceCursor source, Time tracePeriod, Time period);
+
+  //! @brief SimConfig::traceInterval to SimConfig::timeInterval if they differ, otherwise the source as is
+  static UniqTraceCursor decimate(UniqTraceCursor source);
+
+  bool empty() override;
+  const Event& front() override;
+  void pop() override;
+
+private:
+  UniqTraceCursor mSource;
+  const Time mTracePeriod;
+  const uint64_t mRatio;
+  std::map<std::pair<CellId, CellId>, Time> mLastPeriods; //< of the reports by source and target cell
+  bool mIsDelayWarned = false;
+
+  DecimatingTraceCursor(const DecimatingTraceCursor &) = delete;
+  DecimatingTraceCursor& operator =(const DecimatingTraceCursor &) = delete;
+
+  //! @brief drops the front reports of the skipped periods
+  void skipDropped();
+  //! @brief checks the delay of the front report and pops it
+  void popFront();
+};
@@ -0,0 +1,164 @@
+#include "event-queue.h"
+
+#include <algorithm>
+
+
+void HeapEventQueue::push(const Event &event)
+{
+  mHeap.push(event);
+}
+
+Event HeapEventQueue::pop()
+{
+  Event event = mHeap.top();
+  mHeap.pop();
+  return event;
+}
+
+
+TimingWheelEventQueue::TimingWheelEventQueue()
+  : mLevels(levelsCount)
+{
+  for (auto &level : mLevels)
+    level.occupied.fill(0);
+}
+
+void TimingWheelEventQueue::push(const Event &event)
+{
+  assert(event.atTime >= mCurrent);
+  place(event);
+  ++mSize;
+}
+
+Event TimingWheelEventQueue::pop()
+{
+  assert(mSize);
+  Slot *slot = &mLevels[0].slots[slotOf(mCurrent, 0)];
+  if (mReadPos == slot->size())
+    {
+      advance();
+      slot = &mLevels[0].slots[slotOf(mCurrent, 0)];
+    }
+
+  const Event event = (*slot)[mReadPos++];
+  --mSize;
+  return event;
+}
+
+Time TimingWheelEventQueue::nextTime() const
+{
+  assert(mSize);
+  const int current = slotOf(mCurrent, 0);
+  if (mReadPos < mLevels[0].slots[current].size())
+    return mCurrent;
+
+  const int next = nextOccupied(0, current + 1);
+  if (next >= 0)
+    return (mCurrent & ~Time(slotsPerLevel - 1)) | Time(next);
+
+  // without cascading: the nearest upper slot holds the earliest event
+  for (int level = 1; level < levelsCount; level++)
+    {
+      const int slot = nextOccupied(level, slotOf(mCurrent, level) + 1);
+      if (slot < 0)
+        continue;
+
+      const Slot &events = mLevels[level].slots[slot];
+      return std::min_element(events.begin(), events.end())->atTime;
+    }
+
+  ERR("timing wheel is empty while " << mSize << " events expected");
+}
+
+void TimingWheelEventQueue::place(const Event &event)
+{
+  const Time diff = event.atTime ^ mCurrent;
+  int level = 0;
+  while (level + 1 < levelsCount && (diff >> ((level + 1) * levelBits)))
+    ++level;
+
+  const int slot = slotOf(event.atTime, level);
+  mLevels[level].slots[slot].push_back(event);
+  markOccupied(level, slot);
+}
+
+void TimingWheelEventQueue::advance()
+{
+  // the drained slot keeps its capacity for the next round
+  const int drained = slotOf(mCurrent, 0);
+  mLevels[0].slots[drained].clear();
+  markEmpty(0, drained);
+  mReadPos = 0;
+
+  while (true)
+    {
+      const int next = nextOccupied(0, slotOf(mCurrent, 0));
+      if (next >= 0)
+        {
+          mCurrent = (mCurrent & ~Time(slotsPerLevel - 1)) | Time(next);
+          return;
+        }
+
+      // level 0 is over, take the nearest slot from upper levels and spread it downwards
+      bool cascaded = false;
+      for (int level = 1; level < levelsCount && !cascaded; level++)
+        {
+          const int slot = nextOccupied(level, slotOf(mCurrent, level) + 1);
+          if (slot < 0)
+            continue;
+
+          const int shift = level * levelBits;
+          const Time upperMask = (level + 1 < levelsCount) ? ~((Time(1) << (shift + levelBits)) - 1) : 0;
+          mCurrent = (mCurrent & upperMask) | (Time(slot) << shift);
+          cascade(level, slot);
+          cascaded = true;
+        }
+      if (!cascaded)
+        {
+          ERR("timing wheel is empty while " << mSize << " events expected");
+        }
+    }
+}
+
+void TimingWheelEventQueue::cascade(int level, int slot)
+{
+  Slot events;
+  events.swap(mLevels[level].slots[slot]);
+  markEmpty(level, slot);
+
+  for (const auto &event : events)
+    place(event);
+
+  // give the buffer back to keep the slot allocation
+  events.clear();
+  mLevels[level].slots[slot].swap(events);
+}
+
+int TimingWheelEventQueue::nextOccupied(int level, int fromSlot) const
+{
+  const auto &occupied = mLevels[level].occupied;
+  for (int word = fromSlot / 64; word < wordsPerLevel; word++)
+    {
+      uint64_t bits = occupied[word];
+      if (word == fromSlot / 64)
+        bits &= ~uint64_t(0) << (fromSlot % 64);
+      if (bits)
+        return word * 64 + __builtin_ctzll(bits);
+    }
+  return -1;
+}
+
+void TimingWheelEventQueue::markOccupied(int level, int slot)
+{
+  mLevels[level].occupied[slot / 64] |= uint64_t(1) << (slot % 64);
+}
+
+void TimingWheelEventQueue::markEmpty(int level, int slot)
+{
+  mLevels[level].occupied[slot / 64] &= ~(uint64_t(1) << (slot % 64));
+}
+
+int TimingWheelEventQueue::slotOf(Time time, int level)
+{
+  return static_cast<int>((time >> (level * levelBits)) & (slotsPerLevel - 1));
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <vector>
+#include <array>
+
+#include "helpers.h"
+
+//! @class IEventQueue is a storage of pending events ordered by Event::atTime
+class IEventQueue
+{
+public:
+  virtual ~IEventQueue() = default;
+
+  virtual void push(const Event &event) = 0;
+  //! @brief removes and returns the earliest event
+  virtual Event pop() = 0;
+  //! @brief time of the earliest event, the queue must not be empty
+  virtual Time nextTime() const = 0;
+
+  virtual bool empty() const = 0;
+  virtual size_t size() const = 0;
+
+  virtual const char* name() const = 0;
+};
+
+using UniqEventQueue = std::unique_ptr<IEventQueue>;
+
+
+//! @class HeapEventQueue is a binary heap, order of events with equal time is unspecified
+class HeapEventQueue : public IEventQueue
+{
+public:
+  void push(const Event &event) override;
+  Event pop() override;
+  Time nextTime() const override { return mHeap.top().atTime; }
+
+  bool empty() const override { return mHeap.empty(); }
+  size_t size() const override { return mHeap.size(); }
+
+  const char* name() const override { return "binary heap"; }
+
+private:
+  std::priority_queue<Event, std::vector<Event>, std::greater<Event>> mHeap;
+};
+
+
+//! @class TimingWheelEventQueue is a hierarchical timing wheel with 1 us resolution
+//! @brief every level has 256 slots and covers 8 more bits of time. Push is O(1),
+//!  pop is O(1) amortized: each event is cascaded at most once per level.
+//!  Events with equal time are popped in the order they were pushed.
+class TimingWheelEventQueue : public IEventQueue
+{
+public:
+  TimingWheelEventQueue();
+
+  void push(const Event &event) override;
+  Event pop() override;
+  Time nextTime() const override;
+
+  bool empty() const override { return !mSize; }
+  size_t size() const override { return mSize; }
+
+  const char* name() const override { return "timing wheel"; }
+
+private:
+  static constexpr int levelBits = 8;
+  static constexpr int slotsPerLevel = 1 << levelBits;
+  static constexpr int levelsCount = 64 / levelBits;
+  static constexpr int wordsPerLevel = slotsPerLevel / 64;
+
+  using Slot = std::vector<Event>;
+
+  struct Level
+  {
+    std::array<Slot, slotsPerLevel> slots;
+    std::array<uint64_t, wordsPerLevel> occupied; //< bitmap of non-empty slots
+  };
+
+  std::vector<Level> mLevels;
+  Time mCurrent = 0;     //< no stored event is earlier, level 0 slot of this time is being drained
+  size_t mReadPos = 0;   //< position in the level 0 slot of mCurrent
+  size_t mSize = 0;
+
+  void place(const Event &event);
+  void advance();
+  void cascade(int level, int slot);
+
+  int nextOccupied(int level, int fromSlot) const;
+  void markOccupied(int level, int slot);
+  void markEmpty(int level, int slot);
+  static int slotOf(Time time, int level);
+};
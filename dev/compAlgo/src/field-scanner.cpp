@@ -0,0 +1,128 @@
+#include "field-scanner.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+namespace
+{
+  //! @brief powers of ten exact in double
+  const double exactPowersOf10[] = {
+      1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+      1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+  };
+  const int maxExactPower = 22;
+  //! @brief mantissas below are exact in double
+  const uint64_t maxExactMantissa = uint64_t(1) << 53;
+
+  inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
+  inline bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+}
+
+bool FieldScanner::next(int &value)
+{
+  skipSpaces();
+  const bool isNegative = readSign();
+  uint64_t magnitude = 0;
+  bool isExact = true;
+  if (!readDigits(magnitude, isExact) || !isExact || magnitude > uint64_t(std::numeric_limits<int>::max()))
+    return fail();
+  value = isNegative ? -int(magnitude) : int(magnitude);
+  return true;
+}
+
+bool FieldScanner::next(uint64_t &value)
+{
+  skipSpaces();
+  uint64_t result = 0;
+  bool isExact = true;
+  if (!readDigits(result, isExact) || !isExact)
+    return fail();
+  value = result;
+  return true;
+}
+
+bool FieldScanner::next(double &value)
+{
+  skipSpaces();
+  const char *token = mPos;
+  const bool isNegative = readSign();
+
+  uint64_t mantissa = 0;
+  bool isExact = true;
+  int digitsCount = readDigits(mantissa, isExact);
+  int exponent = 0;
+  if (mPos != mEnd && *mPos == '.')
+    {
+      ++mPos;
+      const int fractionDigits = readDigits(mantissa, isExact);
+      digitsCount += fractionDigits;
+      exponent = -fractionDigits;
+    }
+  if (!digitsCount)
+    return fail();
+
+  if (mPos != mEnd && (*mPos == 'e' || *mPos == 'E'))
+    {
+      ++mPos;
+      const bool isNegativeExponent = readSign();
+      uint64_t power = 0;
+      if (!readDigits(power, isExact) || power > 9999)
+        return fail();
+      exponent += isNegativeExponent ? -int(power) : int(power);
+    }
+
+  if (isExact && mantissa < maxExactMantissa && exponent >= -maxExactPower && exponent <= maxExactPower)
+    {
+      // one correctly rounded operation on exact operands gives what strtod does
+      const double magnitude = exponent < 0 ? double(mantissa) / exactPowersOf10[-exponent]
+                                            : double(mantissa) * exactPowersOf10[exponent];
+      value = isNegative ? -magnitude : magnitude;
+      return true;
+    }
+
+  char copy[64];
+  const size_t length = mPos - token;
+  if (length >= sizeof(copy))
+    return fail();
+  memcpy(copy, token, length);
+  copy[length] = '\0';
+  value = strtod(copy, nullptr);
+  return true;
+}
+
+void FieldScanner::skipSpaces()
+{
+  while (mPos != mEnd && isSpace(*mPos))
+    ++mPos;
+}
+
+bool FieldScanner::readSign()
+{
+  if (mPos != mEnd && (*mPos == '-' || *mPos == '+'))
+    return *mPos++ == '-';
+  return false;
+}
+
+int FieldScanner::readDigits(uint64_t &value, bool &isExact)
+{
+  if (mIsBroken)
+    return 0;
+
+  const char *start = mPos;
+  for (; mPos != mEnd && isDigit(*mPos); ++mPos)
+    {
+      const unsigned digit = *mPos - '0';
+      if (value > (std::numeric_limits<uint64_t>::max() - digit) / 10)
+        isExact = false;
+      else if (isExact)
+        value = value * 10 + digit;
+    }
+  return int(mPos - start);
+}
+
+bool FieldScanner::fail()
+{
+  mIsBroken = true;
+  return false;
+}
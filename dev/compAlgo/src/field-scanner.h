@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+
+//! @class FieldScanner reads whitespace separated numbers of one line in place
+//! @brief no locale, no copies and no allocations, unlike std::stringstream. Decimals are
+//!  rounded the same as by strtod, the rare ones that cannot be computed exactly go to strtod.
+//! @note every next() fails once a field is malformed or the line is over
+class FieldScanner
+{
+public:
+  FieldScanner(const char *begin, const char *end) : mPos(begin), mEnd(end) {}
+
+  bool next(int &value);
+  bool next(uint64_t &value);
+  bool next(double &value);
+
+private:
+  const char *mPos;
+  const char *mEnd;
+  bool mIsBroken = false;
+
+  void skipSpaces();
+  bool readSign();
+  //! @return count of the digits read, the value stops growing and isExact is reset on overflow
+  int readDigits(uint64_t &value, bool &isExact);
+  bool fail();
+};
@@ -0,0 +1,169 @@
+#include "gzip-trace-cursor.h"
+
+#include <cstring>
+#include <algorithm>
+
+constexpr size_t GzipTraceCursor::blockSize;
+constexpr size_t GzipTraceCursor::blocksCount;
+
+GzipTraceCursor::GzipTraceCursor(const std::string &location, TraceKind kind, Time from)
+  : mLocation(location)
+  , mKind(kind)
+  , mFile(gzopen(location.c_str(), "rb"))
+  , mBlocks(blocksCount)
+{
+  assert(mFile);
+  LOG("inflating " << location);
+  gzbuffer(mFile, 256 * 1024);
+  for (Block &block : mBlocks)
+    {
+      block.data.resize(blockSize);
+      mFree.push_back(&block);
+    }
+  mInflater = std::thread(&GzipTraceCursor::inflateBlocks, this);
+
+  while (!empty() && front().atTime < from)
+    pop();
+}
+
+GzipTraceCursor::~GzipTraceCursor()
+{
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mCancelled = true;
+  }
+  mHasFree.notify_one();
+  mInflater.join();
+  gzclose(mFile);
+}
+
+bool GzipTraceCursor::empty()
+{
+  if (!mHasFront)
+    refill();
+  return !mHasFront;
+}
+
+const Event &GzipTraceCursor::front()
+{
+  if (!mHasFront)
+    refill();
+  assert(mHasFront);
+  return mFront;
+}
+
+void GzipTraceCursor::pop()
+{
+  assert(mHasFront);
+  mHasFront = false;
+}
+
+void GzipTraceCursor::inflateBlocks()
+{
+  while (true)
+    {
+      Block *block = nullptr;
+      {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mHasFree.wait(lock, [this] { return mCancelled || !mFree.empty(); });
+        if (mCancelled)
+          return;
+        block = mFree.front();
+        mFree.pop_front();
+      }
+
+      const int size = gzread(mFile, block->data.data(), block->data.size());
+      if (size < 0)
+        {
+          int error = 0;
+          WARN(mLocation << " is broken after " << gzoffset(mFile) << " bytes: " << gzerror(mFile, &error));
+        }
+      block->size = std::max(size, 0);
+
+      {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (size > 0)
+          mInflated.push_back(block);
+        mIsOver = size <= 0;
+      }
+      mHasInflated.notify_one();
+      if (size <= 0)
+        return;
+    }
+}
+
+bool GzipTraceCursor::nextBlock()
+{
+  std::unique_lock<std::mutex> lock(mMutex);
+  if (mBlock)
+    {
+      mFree.push_back(mBlock);
+      mBlock = nullptr;
+      mHasFree.notify_one();
+    }
+
+  mHasInflated.wait(lock, [this] { return mIsOver || !mInflated.empty(); });
+  if (mInflated.empty())
+    return false;
+  mBlock = mInflated.front();
+  mInflated.pop_front();
+  mPosition = 0;
+  return true;
+}
+
+void GzipTraceCursor::refill()
+{
+  while (!mHasFront)
+    {
+      if (!mBlock || mPosition == mBlock->size)
+        {
+          if (nextBlock())
+            continue;
+          if (mPartialLine.empty())
+            return;
+
+          // the last line has no line break
+          std::string line;
+          line.swap(mPartialLine);
+          takeLine(line.data(), line.data() + line.size());
+          continue;
+        }
+
+      const char *data = mBlock->data.data();
+      const char *begin = data + mPosition;
+      const char *end = static_cast<const char*>(memchr(begin, '\n', mBlock->size - mPosition));
+      if (!end)
+        {
+          // the line goes on in the next block
+          mPartialLine.append(begin, data + mBlock->size);
+          mPosition = mBlock->size;
+          continue;
+        }
+
+      mPosition = end - data + 1;
+      if (mPartialLine.empty())
+        takeLine(begin, end);
+      else
+        {
+          mPartialLine.append(begin, end);
+          takeLine(mPartialLine.data(), mPartialLine.data() + mPartialLine.size());
+          mPartialLine.clear();
+        }
+    }
+}
+
+void GzipTraceCursor::takeLine(const char *begin, const char *end)
+{
+  // first line dummy
+  if (!mHeaderSkipped)
+    {
+      mHeaderSkipped = true;
+      return;
+    }
+
+  const uint64_t lineNumber = mReadLineNumber++;
+  if (mKind == TraceKind::rlcStats)
+    mHasFront = parseEvent<RlcTraceCursor>(begin, end, lineNumber, mFront);
+  else
+    mHasFront = parseEvent<MeasurementsTraceCursor>(begin, end, lineNumber, mFront);
+}
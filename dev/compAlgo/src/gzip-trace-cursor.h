@@ -0,0 +1,72 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <zlib.h>
+
+#include "trace-cursor.h"
+
+//! @class GzipTraceCursor reads a gzip-compressed text trace "<trace>.gz" without unpacking it to the disk
+//! @brief a helper thread inflates the trace block by block ahead of the parsing,
+//!  the lines are parsed in place as by TraceFileCursor and give the same events and warnings
+class GzipTraceCursor : public ITraceCursor
+{
+public:
+  //! @arg location of the compressed trace
+  //! @arg from time of the first event, earlier ones are skipped
+  GzipTraceCursor(const std::string &location, TraceKind kind, Time from = 0);
+  ~GzipTraceCursor();
+
+  bool empty() override;
+  const Event& front() override;
+  void pop() override;
+
+  //! @return location of the compressed copy of the trace
+  static std::string locationOf(const std::string &trace) { return trace + ".gz"; }
+
+private:
+  static constexpr size_t blockSize = 1 << 20;
+  static constexpr size_t blocksCount = 4; //< inflated ahead at most
+
+  struct Block
+  {
+    std::vector<char> data;
+    size_t size = 0;
+  };
+
+  const std::string mLocation;
+  const TraceKind mKind;
+  gzFile mFile;                 //< read by the helper thread only
+  Event mFront;
+  bool mHasFront = false;
+  bool mHeaderSkipped = false;
+  uint64_t mReadLineNumber = 0; //< of the next line after the header
+  std::string mPartialLine;     //< begins at the end of the previous block
+
+  Block *mBlock = nullptr;      //< being parsed
+  size_t mPosition = 0;         //< in the block
+
+  //- Helper thread ------------------------------------------
+  std::mutex mMutex;
+  std::condition_variable mHasInflated;
+  std::condition_variable mHasFree;
+  std::vector<Block> mBlocks;
+  std::deque<Block*> mInflated;
+  std::deque<Block*> mFree;
+  bool mIsOver = false;         //< no more blocks are inflated
+  bool mCancelled = false;
+  std::thread mInflater;
+  //----------------------------------------------------------
+
+  GzipTraceCursor(const GzipTraceCursor &) = delete;
+  GzipTraceCursor& operator =(const GzipTraceCursor &) = delete;
+
+  void inflateBlocks();
+  bool nextBlock();
+  void refill();
+  void takeLine(const char *begin, const char *end);
+};
@@ -1,22 +1,31 @@
 #include "helpers.h"
 
+namespace
+{
+  thread_local bool isLogMuted = false;
+}
 
-Time SimTimeProvider::mCurrentTime = Converter::milliseconds(0);
+std::ostream &logStream()
+{
+  // formatting into a stream in bad state is skipped, every thread has its own state
+  thread_local std::ostream discarded(nullptr);
+  return isLogMuted ? discarded : std::clog;
+}
 
-Time SimTimeProvider::getTime()
+ScopedLogMute::ScopedLogMute()
+  : mWasMuted(isLogMuted)
 {
-  return mCurrentTime;
+  isLogMuted = true;
 }
 
-void SimTimeProvider::setTime(Time newTime)
+ScopedLogMute::~ScopedLogMute()
 {
-  mCurrentTime = newTime;
+  isLogMuted = mWasMuted;
 }
 
 void TimeMeasurement::start(const std::string &index)
 {
-  mStartTime[index] = clock();
-//  mStartTime[index] = std::chrono::high_resolution_clock::now();
+  mStartTime[index] = std::chrono::steady_clock::now();
 }
 
 void TimeMeasurement::start(const std::string &index, Time time)
@@ -26,12 +35,9 @@ void TimeMeasurement::start(const std::string &index, Time time)
 
 void TimeMeasurement::stop(const std::string &index)
 {
-  mStopTime[index] = clock(); // std::chrono::high_resolution_clock::now();
-//  uint64_t const elapsed =
-//      std::chrono::duration_cast<std::chrono::microseconds>(mStopTime[index] - mStartTime[index]).count();
-//  mStopTime[index] = clock();
+  mStopTime[index] = std::chrono::steady_clock::now();
   uint64_t const elapsed =
-      static_cast<u_int64_t>(double(mStopTime[index] - mStartTime[index]) / CLOCKS_PER_SEC * 1000 * 1000);
+      std::chrono::duration_cast<std::chrono::microseconds>(mStopTime[index] - mStartTime[index]).count();
 
   mStatistics.add(index, elapsed);
 }
@@ -44,5 +50,16 @@ void TimeMeasurement::stop(const std::string &index, Time time)
 }
 
 
-bool FileLogger::mInitiated = false;
-std::fstream FileLogger::mConcreteFileLogger;
+void TimeMeasurement::saveState(CheckpointWriter &writer) const
+{
+  writer.write(mStartTimeManual);
+  writer.write(mStopTimeManual);
+  mStatistics.saveState(writer);
+}
+
+void TimeMeasurement::loadState(CheckpointReader &reader)
+{
+  reader.read(mStartTimeManual);
+  reader.read(mStopTimeManual);
+  mStatistics.loadState(reader);
+}
@@ -2,14 +2,16 @@
 
 #include <iostream>
 #include <time.h>
+#include <chrono>
 #include <fstream>
 #include <unordered_map>
 #include <utility>
 #include <assert.h>
 
 #include "messages.h"
+#include "checkpoint.h"
 
-#define LOG(x)  std::clog << "LOG: " << x << "\n";
+#define LOG(x)  logStream() << "LOG: " << x << "\n";
 #define WARN(x) std::cerr << __FILE__ << "\tWARN: " << x << "\n";
 #define ERR(x)  std::cerr << __FILE__ << "\tERR: " << x << "\n"; \
                 assert(false); \
@@ -25,11 +27,34 @@
 
 #define UNUSED(x) [&x] {} ()
 
+//! @return std::clog, or a stream without buffer dropping the records if LOG is muted in the current thread
+std::ostream& logStream();
+
+//! @class ScopedLogMute mutes LOG in the current thread while it lives, the other threads keep logging,
+//!  e.g. in the workers of concurrent simulations whose logs would only interleave
+class ScopedLogMute
+{
+public:
+  ScopedLogMute();
+  ~ScopedLogMute();
+
+private:
+  const bool mWasMuted;
+
+  ScopedLogMute(const ScopedLogMute &) = delete;
+  ScopedLogMute& operator =(const ScopedLogMute &) = delete;
+};
+
 
 class SimConfig
 {
 public:
   static constexpr int timeInterval = 10; // 5 / 10 / 20 / 40
+  //! @brief [ms] measurements period of the traces in ./input/<traceInterval>/, a divisor of timeInterval:
+  //!  a finer trace is decimated to timeInterval, see DecimatingTraceCursor. The decimation assumes that
+  //!  a coarser run reports in the first period of the finer one and that the report delays stay below
+  //!  traceInterval. It has not been validated against a coarser trace recorded by ns-3.
+  static constexpr int traceInterval = timeInterval;
   enum DecisionAlgo
   {
     naive
@@ -57,6 +82,49 @@ public:
   static constexpr int kamaF =    1    ;
   static constexpr int kamaS =  20    ;
 
+
+  enum EventQueueType
+  {
+    binaryHeap
+    , timingWheel
+  };
+
+  static constexpr EventQueueType eventQueueType = timingWheel;
+
+  enum TraceInputMode
+  {
+    preloadTraces     //< parse traces into the event queue before the run
+    , streamTraces    //< read traces lazily during the run
+    , pipelineTraces  //< read traces on a parser thread during the run
+  };
+
+  static constexpr TraceInputMode traceInputMode = pipelineTraces;
+
+  enum RlcOutputMode
+  {
+    rlcTextOutput         //< the lines of the transmitted packets to DlRlcStats.txt
+    , rlcSelectionOutput  //< a bit per packet to DlRlcStats.sel, see PacketSelection
+    , rlcNoOutput         //< for tuning runs, the throughput is only in MacStatistics
+  };
+
+  static constexpr RlcOutputMode rlcOutputMode = rlcTextOutput;
+
+  //! @brief the output files are written gzip-compressed as "<file>.gz", see OutputWriter
+  static constexpr bool compressOutputs = false;
+
+};
+
+//! @brief decision algorithm parameters of one simulation, SimConfig gives the defaults
+//! @note kept per SimContext, so simulations of one process may be tuned differently
+struct AlgoConfig
+{
+  SimConfig::DecisionAlgo algoType = SimConfig::algoType;
+  int wmaSmmDuration = SimConfig::wmaSmmDuration;
+  int approxAlgoWindowSize = SimConfig::approxAlgoWindowSize;
+  int approxAlgoXOffset = SimConfig::approxAlgoXOffset;
+  int kamaN = SimConfig::kamaN;
+  int kamaF = SimConfig::kamaF;
+  int kamaS = SimConfig::kamaS;
 };
 
 class Converter
@@ -67,20 +135,6 @@ public:
   static constexpr uint64_t microseconds(int64_t s) { return s; }
 };
 
-class Simulator;
-class SimTimeProvider
-{
-public:
-  static Time getTime();
-
-  friend class Simulator;
-private:
-  static Time mCurrentTime;
-
-  static void setTime(Time newTime);
-};
-
-
 template <typename T>
 class Statistics
 {
@@ -105,6 +159,22 @@ public:
   T minimum(const std::string &index) { return mMin[index]; }
   T maximum(const std::string &index) { return mMax[index]; }
 
+  void saveState(CheckpointWriter &writer) const
+  {
+    writer.write(mMin);
+    writer.write(mMax);
+    writer.write(mSum);
+    writer.write(mCounter);
+  }
+
+  void loadState(CheckpointReader &reader)
+  {
+    reader.read(mMin);
+    reader.read(mMax);
+    reader.read(mSum);
+    reader.read(mCounter);
+  }
+
 private:
   std::unordered_map<std::string, T> mMin, mMax;
   std::unordered_map<std::string, decltype(std::declval<T>() + std::declval<T>())> mSum;
@@ -126,35 +196,16 @@ public:
   int64_t minimum(const std::string &index) { return mStatistics.minimum(index); }
   int64_t maximum(const std::string &index) { return mStatistics.maximum(index); }
 
+  //! @note wall clock measurements in progress are not kept, they make no sense in another process
+  void saveState(CheckpointWriter &writer) const;
+  void loadState(CheckpointReader &reader);
+
 private:
-//  typedef decltype(std::chrono::high_resolution_clock::now()) RealTimePoint;
-//  std::unordered_map<std::string, RealTimePoint> mStartTime, mStopTime;
-  std::unordered_map<std::string, clock_t> mStartTime, mStopTime;
+  //! @brief wall time: the processor time of clock() also counts the other threads of the process,
+  //!  such as the trace parser of PipelinedTraceCursor
+  using WallTimePoint = std::chrono::steady_clock::time_point;
+  std::unordered_map<std::string, WallTimePoint> mStartTime, mStopTime;
   std::unordered_map<std::string, Time> mStartTimeManual, mStopTimeManual;
   Statistics<uint64_t> mStatistics;
 };
 
-
-class FileLogger
-{
-public:
-  template <typename T>
-  static void write(T &stream)
-  {
-    if (!mInitiated)
-      {
-        mConcreteFileLogger.open("./output/log.log", std::ios_base::out | std::ios_base::trunc);
-        assert(mConcreteFileLogger.is_open());
-        mInitiated = true;
-      }
-    mConcreteFileLogger << stream << "\n";
-    mConcreteFileLogger.flush();
-  }
-
-
-private:
-  static std::fstream mConcreteFileLogger;
-  static bool mInitiated;
-};
-
-
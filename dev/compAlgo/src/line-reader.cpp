@@ -0,0 +1,99 @@
+#include "line-reader.h"
+
+#include <cstring>
+#include <cctype>
+#include <algorithm>
+
+namespace
+{
+  bool isBlank(const char *begin, const char *end)
+  {
+    for (; begin != end && *begin != '%'; ++begin)
+      if (!isspace(static_cast<unsigned char>(*begin)))
+        return false;
+    return true;
+  }
+}
+
+constexpr size_t LineReader::blockSize;
+
+LineReader::LineReader(const std::string &location)
+  : mFile(gzopen(location.c_str(), "rb"))
+  , mBlock(blockSize)
+{
+  if (mFile)
+    gzbuffer(mFile, 256 * 1024);
+}
+
+LineReader::~LineReader()
+{
+  if (mFile)
+    gzclose(mFile);
+}
+
+bool LineReader::next(const char *&begin, const char *&end)
+{
+  do
+    {
+      if (!nextLine(begin, end))
+        return false;
+    }
+  while (isBlank(begin, end));
+  return true;
+}
+
+bool LineReader::nextLine(const char *&begin, const char *&end)
+{
+  mPartialLine.clear();
+  while (true)
+    {
+      if (mPosition == mSize)
+        {
+          if (!readBlock())
+            {
+              // the last line has no line break
+              begin = mPartialLine.data();
+              end = begin + mPartialLine.size();
+              return !mPartialLine.empty();
+            }
+          continue;
+        }
+
+      const char *data = mBlock.data();
+      const char *lineBegin = data + mPosition;
+      const char *lineEnd = static_cast<const char*>(memchr(lineBegin, '\n', mSize - mPosition));
+      if (!lineEnd)
+        {
+          // the line goes on in the next block
+          mPartialLine.append(lineBegin, data + mSize);
+          mPosition = mSize;
+          continue;
+        }
+
+      mPosition = lineEnd - data + 1;
+      if (mPartialLine.empty())
+        {
+          begin = lineBegin;
+          end = lineEnd;
+        }
+      else
+        {
+          mPartialLine.append(lineBegin, lineEnd);
+          begin = mPartialLine.data();
+          end = begin + mPartialLine.size();
+        }
+      return true;
+    }
+}
+
+bool LineReader::readBlock()
+{
+  if (mIsOver || !mFile)
+    return false;
+  const int size = gzread(mFile, mBlock.data(), mBlock.size());
+  mIsBroken = size < 0;
+  mIsOver = size <= 0;
+  mSize = std::max(size, 0);
+  mPosition = 0;
+  return size > 0;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <zlib.h>
+
+//! @class LineReader reads a text or gzip-compressed file line by line through one block,
+//!  comments and blank lines are skipped as numpy.loadtxt does
+//! @brief for the tools streaming the traces and the outputs in constant memory
+class LineReader
+{
+public:
+  explicit LineReader(const std::string &location);
+  ~LineReader();
+
+  bool isOpen() const { return mFile; }
+  //! @brief the file cannot be inflated up to its end
+  bool isBroken() const { return mIsBroken; }
+
+  //! @brief the line is valid until the next call
+  //! @return false at the end of the file
+  bool next(const char *&begin, const char *&end);
+  //! @brief as next(), but every line is given as it is, the comments and the blank ones too
+  bool nextLine(const char *&begin, const char *&end);
+
+private:
+  static constexpr size_t blockSize = 1 << 20;
+
+  gzFile mFile;
+  std::vector<char> mBlock;
+  size_t mSize = 0;
+  size_t mPosition = 0;
+  bool mIsOver = false;
+  bool mIsBroken = false;
+  std::string mPartialLine; //< begins at the end of the previous block
+
+  LineReader(const LineReader &) = delete;
+  LineReader& operator =(const LineReader &) = delete;
+
+  bool readBlock();
+};
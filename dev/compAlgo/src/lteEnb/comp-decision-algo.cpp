@@ -3,20 +3,20 @@
 #include <cmath>
 #include <algorithm>
 
-CompSchedulingAlgo::CompSchedulingAlgo(CsiJournalPtr j, CellIdVectorPtr compGroup)
-  : mCsiJournal(j)
+#include "../sim-context.h"
+
+CompSchedulingAlgo::CompSchedulingAlgo(CsiJournalPtr j, CellIdVectorPtr compGroup, SimContext &context)
+  : mContext(context)
+  , mCsiJournal(j)
   , mCompGroup(compGroup)
-  , mWmaIndicator(new WmaIndicator(j))
-  , mKamaIndicator(new KamaIndicator(j))
-  , mInterpolation(new InterpolationIndicator(j))
-  , mApproxIndicator(new ApproximationIndicator(j))
+  , mMovingScoreLogger(context.outputFile("moving_score.log", "% time [us]\tcellId\tcellId\tvalue\n"))
+  , mWmaIndicator(new WmaIndicator(j, context.algoConfig()))
+  , mKamaIndicator(new KamaIndicator(j, context.algoConfig()))
+  , mInterpolation(new InterpolationIndicator(j, context.algoConfig()))
+  , mApproxIndicator(new ApproximationIndicator(j, context.algoConfig()))
 {
   assert(j && compGroup);
 
-  mMovingScoreLogger.open("output/moving_score.log", std::ios_base::out | std::ios_base::trunc);
-  assert(mMovingScoreLogger.is_open());
-  mMovingScoreLogger << "% time [us]\tcellId\tcellId\tvalue\n";
-
 //  mKamaIndicator->setPreventiveAnalysis(true);
 //  mWmaIndicator->setPreventiveAnalysis(true);
 }
@@ -36,7 +36,22 @@ void CompSchedulingAlgo::setCompGroup(CellIdVectorPtr cg)
 CompSchedulingAlgo::~CompSchedulingAlgo()
 {
   mMovingScoreLogger.flush();
-  mMovingScoreLogger.close();
+}
+
+void CompSchedulingAlgo::saveState(CheckpointWriter &writer) const
+{
+  mWmaIndicator->saveState(writer);
+  mKamaIndicator->saveState(writer);
+  mInterpolation->saveState(writer);
+  mApproxIndicator->saveState(writer);
+}
+
+void CompSchedulingAlgo::loadState(CheckpointReader &reader)
+{
+  mWmaIndicator->loadState(reader);
+  mKamaIndicator->loadState(reader);
+  mInterpolation->loadState(reader);
+  mApproxIndicator->loadState(reader);
 }
 
 void CompSchedulingAlgo::update(CellId cellId)
@@ -54,7 +69,7 @@ void CompSchedulingAlgo::update(CellId cellId)
 
 CellId CompSchedulingAlgo::redefineBestCell(CellId lastScheduled)
 {
-  switch (SimConfig::algoType)
+  switch (mContext.algoConfig().algoType)
     {
     case SimConfig::naive:
       return predictorSimpleMaxValue(lastScheduled);
@@ -84,7 +99,7 @@ CellId CompSchedulingAlgo::predictorPureRawForecastWMA(CellId lastScheduled)
 {
   const double hysteresis = .2;
 
-  std::map<CellId, double> signalForecast;
+  CellValues &signalForecast = resetSignalForecast(lastScheduled);
 
   CellId nextDecision = lastScheduled;
   double estimatedBestSignal = signalForecast[lastScheduled];
@@ -145,7 +160,7 @@ CellId CompSchedulingAlgo::predictorPureRawForecastKama(CellId lastScheduled)
 {
   const double hysteresis = .2;
 
-  std::map<CellId, double> signalForecast;
+  CellValues &signalForecast = resetSignalForecast(lastScheduled);
 
   CellId nextDecision = lastScheduled;
   double estimatedBestSignal = signalForecast[lastScheduled];
@@ -206,7 +221,7 @@ CellId CompSchedulingAlgo::predictorMAForecast(CellId lastScheduled)
 {
   const double hysteresis = .2;
 
-  std::map<CellId, double> signalForecast;
+  CellValues &signalForecast = resetSignalForecast(lastScheduled);
   signalForecast[lastScheduled] = mKamaIndicator->forecast(lastScheduled);
 
   CellId nextDecision = lastScheduled;
@@ -408,22 +423,32 @@ bool CompSchedulingAlgo::haveTooLittleValues()
 
 void CompSchedulingAlgo::writeScore(CellId cellId, double aveValue, double rawValue)
 {
-  mMovingScoreLogger << SimTimeProvider::getTime() << "\t" << cellId << "\t" << cellId << "\t"
+  mMovingScoreLogger << mContext.getTime() << "\t" << cellId << "\t" << cellId << "\t"
                      << rawValue << "\n";
-  mMovingScoreLogger << SimTimeProvider::getTime() << "\t" << cellId + 10 << "\t" << cellId + 10
+  mMovingScoreLogger << mContext.getTime() << "\t" << cellId + 10 << "\t" << cellId + 10
                      << "\t" << aveValue << "\n";
 }
 
+Time CompSchedulingAlgo::windowDuration() const
+{
+  return std::max({mInterpolation->windowDuration(), mKamaIndicator->windowDuration(),
+                   mWmaIndicator->windowDuration()});
+}
+
+CellValues& CompSchedulingAlgo::resetSignalForecast(CellId lastScheduled)
+{
+  CellId maxCellId = lastScheduled;
+  for (auto cellId : *mCompGroup)
+    maxCellId = std::max(maxCellId, cellId);
+  mSignalForecast.reset(maxCellId);
+  return mSignalForecast;
+}
+
 void CompSchedulingAlgo::removeOldValues()
 {
-  std::vector<Time> winDurations {
-      mInterpolation->windowDuration()
-      , mKamaIndicator->windowDuration()
-      , mWmaIndicator->windowDuration()
-  };
-  const auto windowDuration = *std::max_element(winDurations.begin(), winDurations.end());
+  const auto windowDuration = this->windowDuration();
   assert(windowDuration);
-  const auto barrier = SimTimeProvider::getTime() - windowDuration;
+  const auto barrier = mContext.getTime() - windowDuration;
   for (auto &csiPair : *mCsiJournal)
     {
       CsiArray &array = csiPair.second;
@@ -9,10 +9,27 @@
 #include "trendIndicators/approximation-indicator.h"
 
 
+class SimContext;
+
+//! @brief values per cell, zero for the cells not set, the storage is kept between the uses
+class CellValues
+{
+public:
+  void reset(CellId maxCellId) { mValues.assign(maxCellId + 1, 0.0); }
+  double& operator [](CellId cellId)
+  {
+    assert(cellId >= 0 && size_t(cellId) < mValues.size());
+    return mValues[cellId];
+  }
+
+private:
+  std::vector<double> mValues;
+};
+
 class CompSchedulingAlgo
 {
 public:
-  CompSchedulingAlgo(CsiJournalPtr j, CellIdVectorPtr compGroup);
+  CompSchedulingAlgo(CsiJournalPtr j, CellIdVectorPtr compGroup, SimContext &context);
 
   void setJournal(CsiJournalPtr j);
   void setCompGroup(CellIdVectorPtr cg);
@@ -22,19 +39,30 @@ public:
   void update(CellId cellId);
   CellId redefineBestCell(CellId lastScheduled);
 
+  //! @brief the longest window of the indicators, older measurements are dropped
+  Time windowDuration() const;
+
+  //! @brief indicator internals, the journal and the group are kept by the scheduler
+  void saveState(CheckpointWriter &writer) const;
+  void loadState(CheckpointReader &reader);
+
 private:
   CompSchedulingAlgo& operator=(const CompSchedulingAlgo&) = delete;
   CompSchedulingAlgo(const CompSchedulingAlgo&) = delete;
 
+  SimContext &mContext;
   CsiJournalPtr mCsiJournal;
   CellIdVectorPtr mCompGroup;
-  std::fstream mMovingScoreLogger;
+  std::ostream &mMovingScoreLogger;
 
   UniqWmaIndicator mWmaIndicator;
   UniqKamaIndicator mKamaIndicator;
   UniqInterpolationIndicator mInterpolation;
   UniqApproximationIndicator mApproxIndicator;
 
+  CellValues mSignalForecast; //< of the predictors
+  CellValues& resetSignalForecast(CellId lastScheduled);
+
 
   void writeScore(CellId cellId, double aveValue, double rawValue);
   void removeOldValues();
@@ -2,14 +2,53 @@
 
 #include <assert.h>
 
+#include "../sim-context.h"
+
+FfMacSchedSapUser::FfMacSchedSapUser(SimContext &context)
+  : mContext(context)
+  , mDecisions(context.arena())
+{
+}
+
+FfMacSchedSapUser::SchedulerDecisions& FfMacSchedSapUser::decisionsOf(int cellId)
+{
+  auto decisions = mDecisions.find(cellId);
+  if (decisions == mDecisions.end())
+    decisions = mDecisions.emplace(cellId, SchedulerDecisions(mContext.arena())).first;
+  return decisions->second;
+}
+
+void FfMacSchedSapUser::saveState(CheckpointWriter &writer) const
+{
+  writer.write(mDecisions.size());
+  for (const auto &decisions : mDecisions)
+    {
+      writer.write(decisions.first);
+      writer.write(decisions.second);
+    }
+}
+
+void FfMacSchedSapUser::loadState(CheckpointReader &reader)
+{
+  mDecisions.clear();
+  size_t cellsCount = 0;
+  reader.read(cellsCount);
+  for (size_t i = 0; i < cellsCount && reader.good(); i++)
+    {
+      int cellId = 0;
+      reader.read(cellId);
+      reader.read(decisionsOf(cellId));
+    }
+}
+
 void FfMacSchedSapUser::schedDlConfigInd(int cellId, const SchedDlConfigIndParameters &params)
 {
-  mDecisions[cellId].push_back(std::make_pair(SimTimeProvider::getTime() + macToChannelDelay, params));
-  if (mDecisions[cellId].size() < 10)
+  SchedulerDecisions& decisions = decisionsOf(cellId);
+  decisions.push_back(std::make_pair(mContext.getTime() + macToChannelDelay, params));
+  if (decisions.size() < 10)
     return;
 
-  const Time currentTime = SimTimeProvider::getTime();
-  SchedulerDecisions& decisions = mDecisions[cellId];
+  const Time currentTime = mContext.getTime();
   while (decisions.size() >= 2 && decisions[0].first < currentTime && decisions[1].first < currentTime)
     decisions.pop_front();
 }
@@ -17,17 +56,16 @@ void FfMacSchedSapUser::schedDlConfigInd(int cellId, const SchedDlConfigIndParam
 bool FfMacSchedSapUser::getDciDecision(int cellId, bool peek)
 {
   bool lastAvailableDecision = false;
-  const Time currentTime = SimTimeProvider::getTime();
-
-  const auto copyOfCellDecisions = mDecisions[cellId];
+  const Time currentTime = mContext.getTime();
 
-  SchedulerDecisions& decisions = mDecisions[cellId];
-  while(!decisions.empty() && decisions.front().first <= currentTime)
+  SchedulerDecisions& decisions = decisionsOf(cellId);
+  size_t outdated = 0;
+  while(outdated < decisions.size() && decisions[outdated].first <= currentTime)
     {
-      lastAvailableDecision = decisions.front().second.dciDecision;
-      if (decisions.size() > 1)
+      lastAvailableDecision = decisions[outdated].second.dciDecision;
+      if (outdated + 1 < decisions.size())
         {
-          decisions.pop_front(); // next decisions will be without delay
+          outdated++; // next decisions will be without delay
         }
       else
         {
@@ -35,8 +73,8 @@ bool FfMacSchedSapUser::getDciDecision(int cellId, bool peek)
         }
     }
 
-  if (peek)
-    mDecisions[cellId] = copyOfCellDecisions;
+  if (!peek)
+    decisions.erase(decisions.begin(), decisions.begin() + outdated);
 
   return lastAvailableDecision;
 }
@@ -44,9 +82,9 @@ bool FfMacSchedSapUser::getDciDecision(int cellId, bool peek)
 int FfMacSchedSapUser::getDirectCellId()
 {
   const bool peek = true;
-  std::vector<int> decisions {getDciDecision(1, peek), getDciDecision(2, peek), getDciDecision(3, peek)};
+  const int decisions[] {getDciDecision(1, peek), getDciDecision(2, peek), getDciDecision(3, peek)};
   int cellId = -1;
-  for (unsigned int i = 0; i < decisions.size(); i++)
+  for (unsigned int i = 0; i < sizeof(decisions) / sizeof(decisions[0]); i++)
     {
       int decision = decisions[i];
       if (!decision)
@@ -55,7 +93,7 @@ int FfMacSchedSapUser::getDirectCellId()
         cellId = i;
       else
         {
-          ERR("@" << SimTimeProvider::getTime() << "\tASSERT:\tDual transmission");
+          ERR("@" << mContext.getTime() << "\tASSERT:\tDual transmission");
         }
     }
   return cellId;
@@ -63,7 +101,7 @@ int FfMacSchedSapUser::getDirectCellId()
 
 bool FfMacSchedSapUser::peekDciDecision(int cellId)
 {
-  SchedulerDecisions& decisions = mDecisions[cellId];
+  SchedulerDecisions& decisions = decisionsOf(cellId);
   return (decisions.empty())? false : decisions.front().second.dciDecision;
 }
 
@@ -4,12 +4,14 @@
 #include <deque>
 
 #include "../helpers.h"
+#include "../memory-arena.h"
 
+class SimContext;
 
 class FfMacSchedSapUser
 {
 public:
-  FfMacSchedSapUser() = default;
+  FfMacSchedSapUser(SimContext &context);
 
   struct SchedDlConfigIndParameters
   {
@@ -25,9 +27,16 @@ public:
 
   Time getMacToChannelDelay() const;
 
+  void saveState(CheckpointWriter &writer) const;
+  void loadState(CheckpointReader &reader);
+
 private:
+  SimContext &mContext;
   const Time macToChannelDelay = Converter::milliseconds(1);
-  using SchedulerDecisions = std::deque<std::pair<Time, SchedDlConfigIndParameters>>;
+  using SchedulerDecision = std::pair<Time, SchedDlConfigIndParameters>;
+  using SchedulerDecisions = std::deque<SchedulerDecision, ArenaAllocator<SchedulerDecision>>;
+
+  std::map<int, SchedulerDecisions, std::less<int>, ArenaAllocator<std::pair<const int, SchedulerDecisions>>> mDecisions;
 
-  std::map<int, SchedulerDecisions> mDecisions;
+  SchedulerDecisions& decisionsOf(int cellId);
 };
@@ -3,21 +3,24 @@
 #include <algorithm>
 
 #include "x2-channel.h"
-#include "../simulator.h"
+#include "../sim-context.h"
 
-FfMacScheduler::FfMacScheduler(CellId cellId)
-  : mCellId(cellId)
+FfMacScheduler::FfMacScheduler(CellId cellId, SimContext &context)
+  : mContext(context)
+  , mCellId(cellId)
   , mIsLeader(false)
   , mDirectParticipantCellId(-1)
   , mIsDirectParticipant(false)
   , mLeaderCellId(-1)
-  , mCompAlgo(new CompSchedulingAlgo(mCsiHistory, mCompGroup))
+  , mCompAlgo(new CompSchedulingAlgo(mCsiHistory, mCompGroup, context))
+  , mPendingTransitions(context.arena())
   , mLastScheduledCellId(cellId)
 {
 }
 
 FfMacScheduler::FfMacScheduler(FfMacScheduler &&scheduler)
-  : mCellId(scheduler.mCellId)
+  : mContext(scheduler.mContext)
+  , mCellId(scheduler.mCellId)
   , mIsLeader(scheduler.mIsLeader)
   , mDirectParticipantCellId(scheduler.mDirectParticipantCellId)
   , mIsDirectParticipant(scheduler.mIsDirectParticipant)
@@ -26,8 +29,8 @@ FfMacScheduler::FfMacScheduler(FfMacScheduler &&scheduler)
   , mCsiHistory(std::move(scheduler.mCsiHistory))
   , mMacSapUser(scheduler.mMacSapUser)
   , mCompAlgo(std::move(scheduler.mCompAlgo))
-  , mInternalEvents(std::move(scheduler.mInternalEvents))
-  , mScheduledDirectCellId(scheduler.mScheduledDirectCellId)
+  , mPendingTransitions(std::move(scheduler.mPendingTransitions))
+  , mWakeup(scheduler.mWakeup)
   , mLastScheduledCellId(scheduler.mLastScheduledCellId)
   , mlCellSwitchWatch(scheduler.mlCellSwitchWatch)
   , mlHistoryLenCounter(std::move(scheduler.mlHistoryLenCounter))
@@ -49,8 +52,8 @@ FfMacScheduler::~FfMacScheduler()
           << "\tmin: "<< mlCellSwitchWatch.minimum(mlCellSwitchIndex) / 1000.0
           << "\tmax: " << mlCellSwitchWatch.maximum(mlCellSwitchIndex) / 1000.0
           << "\tTotal switches: " << mlCellSwitchCounter);
-      FileLogger::write(averageCellSwitchI);
-      FileLogger::write(mlCellSwitchCounter);
+      mContext.fileLogger().write(averageCellSwitchI);
+      mContext.fileLogger().write(mlCellSwitchCounter);
 
 
       LOG("\tCell measurements history length on decision moment:\n\taverage per cell:");
@@ -62,6 +65,44 @@ FfMacScheduler::~FfMacScheduler()
     }
 }
 
+void FfMacScheduler::saveState(CheckpointWriter &writer) const
+{
+  writer.write(mIsLeader);
+  writer.write(mDirectParticipantCellId);
+  writer.write(mIsDirectParticipant);
+  writer.write(mLeaderCellId);
+  writer.write(*mCompGroup);
+  writer.write(*mCsiHistory);
+  mCompAlgo->saveState(writer);
+  writer.write(mPendingTransitions);
+  writer.write(mWakeup);
+  writer.write(mLastScheduledCellId);
+  writer.write(mLastSwichTime);
+
+  mlCellSwitchWatch.saveState(writer);
+  writer.write(mlCellSwitchCounter);
+  writer.write(mlHistoryLenCounter);
+}
+
+void FfMacScheduler::loadState(CheckpointReader &reader)
+{
+  reader.read(mIsLeader);
+  reader.read(mDirectParticipantCellId);
+  reader.read(mIsDirectParticipant);
+  reader.read(mLeaderCellId);
+  reader.read(*mCompGroup);   //< in place, the decision algorithm shares them
+  reader.read(*mCsiHistory);
+  mCompAlgo->loadState(reader);
+  reader.read(mPendingTransitions);
+  reader.read(mWakeup);
+  reader.read(mLastScheduledCellId);
+  reader.read(mLastSwichTime);
+
+  mlCellSwitchWatch.loadState(reader);
+  reader.read(mlCellSwitchCounter);
+  reader.read(mlHistoryLenCounter);
+}
+
 void FfMacScheduler::setLeader(CellId cellId)
 {
   mLeaderCellId = cellId;
@@ -79,7 +120,7 @@ void FfMacScheduler::setLeader(CellId cellId)
       X2Message message;
       message.type = X2Message::leadershipInd;
       message.leaderCellId = mCellId;
-      X2Channel::instance()->send(-1, message);
+      mContext.x2Channel().send(-1, message);
     }
   schedDlTriggerReq();
 }
@@ -125,7 +166,7 @@ void FfMacScheduler::schedDlCqiInfoReq(CellId tCellId, CsiUnit csi)
           msg.type = X2Message::measuresInd;
           msg.report = measReport;
 
-          X2Channel::instance()->send(mLeaderCellId, msg);
+          mContext.x2Channel().send(mLeaderCellId, msg);
         }
       return;
     }
@@ -145,9 +186,9 @@ void FfMacScheduler::schedDlCqiInfoReq(CellId tCellId, CsiUnit csi)
   if (csi.first == array.back().first)
     {
 #ifndef NDEBUG
-      static int newLess = 0;
-      static int newGreater = 0;
-      static int newSame = 0;
+      static thread_local int newLess = 0;
+      static thread_local int newGreater = 0;
+      static thread_local int newSame = 0;
       if (csi.second > array.back().second)
         newGreater++;
       else if (csi.second < array.back().second)
@@ -168,7 +209,7 @@ void FfMacScheduler::schedDlCqiInfoReq(CellId tCellId, CsiUnit csi)
     array.pop_front();
 
 
-  if (SimTimeProvider::getTime() > Converter::milliseconds(150))
+  if (mContext.getTime() > Converter::milliseconds(150))
     {
       processREChanges();
     }
@@ -176,13 +217,13 @@ void FfMacScheduler::schedDlCqiInfoReq(CellId tCellId, CsiUnit csi)
 
 void FfMacScheduler::onTimeout()
 {
-  const Time currentTime = SimTimeProvider::getTime();
-  auto &executionQ = mInternalEvents[currentTime];
-  while (!executionQ.empty())
+  const Time currentTime = mContext.getTime();
+  mWakeup.isValid = false; // it has just expired
+  while (!mPendingTransitions.empty() && mPendingTransitions.front().atTime <= currentTime)
     {
-      const auto event = executionQ.front();
-      executionQ.pop();
-      switch (event)
+      const PendingTransition transition = mPendingTransitions.front();
+      mPendingTransitions.pop_front();
+      switch (transition.event)
         {
         case SchedulerEvent::startTx:
           mIsDirectParticipant = true;
@@ -191,8 +232,7 @@ void FfMacScheduler::onTimeout()
           break;
         case SchedulerEvent::stopTx:
           mIsDirectParticipant = false;
-          mDirectParticipantCellId = mScheduledDirectCellId[currentTime];
-          mScheduledDirectCellId.erase(currentTime);
+          mDirectParticipantCellId = transition.directCellId;
           schedDlTriggerReq();
           break;
         case SchedulerEvent::updateDciDecision:
@@ -200,15 +240,15 @@ void FfMacScheduler::onTimeout()
           break;
         }
     }
-  mInternalEvents.erase(currentTime);
+  updateWakeup();
 }
 
 void FfMacScheduler::switchDirectCell(int cellId)
 {
   assert(std::find(mCompGroup->begin(), mCompGroup->end(), cellId) != mCompGroup->end());
 
-  Time currentTime = SimTimeProvider::getTime();
-  Time applyChanges = currentTime + X2Channel::instance()->getLatency() + Converter::microseconds(10);
+  Time currentTime = mContext.getTime();
+  Time applyChanges = currentTime + mContext.x2Channel().getLatency() + Converter::microseconds(10);
   // switch traffic OFF at old cell
   if (mLastScheduledCellId != mCellId)
     {
@@ -218,7 +258,7 @@ void FfMacScheduler::switchDirectCell(int cellId)
       msgOff.mustSendTraffic = false;
       msgOff.applyDirectMembership = applyChanges;
 
-      X2Channel::instance()->send(mLastScheduledCellId, msgOff);
+      mContext.x2Channel().send(mLastScheduledCellId, msgOff);
     }
   else
     {
@@ -235,7 +275,7 @@ void FfMacScheduler::switchDirectCell(int cellId)
       msgOn.mustSendTraffic = true;
       msgOn.applyDirectMembership = applyChanges;
 
-      X2Channel::instance()->send(cellId, msgOn);
+      mContext.x2Channel().send(cellId, msgOn);
     }
   else
     {
@@ -254,32 +294,41 @@ void FfMacScheduler::switchDirectCell(int cellId)
 }
 
 
-void FfMacScheduler::setTimeout(Time when)
+void FfMacScheduler::updateWakeup()
+{
+  if (!mPendingTransitions.empty() && mWakeup.isValid && mWakeup.atTime == mPendingTransitions.front().atTime)
+    return;
+
+  mContext.timers().cancel(mWakeup);
+  if (!mPendingTransitions.empty())
+    mWakeup = mContext.timers().schedule(mCellId, mPendingTransitions.front().atTime);
+}
+
+void FfMacScheduler::enqueueTransition(const PendingTransition &transition)
 {
-  Event event { EventType::l2Timeout, when };
-  event.cellId = mCellId;
-  Simulator::instance()->scheduleEvent(event);
+  assert(transition.atTime >= mContext.getTime());
+  // the transitions come in time order, so it is appended almost always
+  auto position = std::upper_bound(mPendingTransitions.begin(), mPendingTransitions.end(), transition.atTime,
+                                   [](Time t, const PendingTransition &p) { return t < p.atTime; });
+  mPendingTransitions.insert(position, transition);
+  updateWakeup();
 }
 
 void FfMacScheduler::enqueueTx(Time start)
 {
-  assert(start >= SimTimeProvider::getTime());
-  mInternalEvents[start].push(SchedulerEvent::startTx);
-  setTimeout(start);
+  enqueueTransition({start, SchedulerEvent::startTx, -1});
 }
 
 void FfMacScheduler::enqueueTxStop(Time stop, int scheduledDirectCellId)
 {
-  mInternalEvents[stop].push(SchedulerEvent::stopTx);
-  mScheduledDirectCellId[stop] = scheduledDirectCellId;
-  setTimeout(stop);
+  enqueueTransition({stop, SchedulerEvent::stopTx, scheduledDirectCellId});
 }
 
 
 
 void FfMacScheduler::processREChanges()
 {
-  if (SimTimeProvider::getTime() < mLastSwichTime + Converter::milliseconds(1))
+  if (mContext.getTime() < mLastSwichTime + Converter::milliseconds(1))
     return;
 
   for (const auto &cellHistory : *mCsiHistory)
@@ -293,7 +342,7 @@ void FfMacScheduler::processREChanges()
 
   if (cellIdNext != mLastScheduledCellId)
     {
-      DEBUG("@" << SimTimeProvider::getTime()
+      DEBUG("@" << mContext.getTime()
           << "  cell switch from " << mLastScheduledCellId << " to " << cellIdNext);
       switchDirectCell(cellIdNext);
     }
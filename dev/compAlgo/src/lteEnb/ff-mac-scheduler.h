@@ -3,14 +3,17 @@
 #include <initializer_list>
 
 #include "../helpers.h"
+#include "../timer-service.h"
 #include "ff-mac-sched-sap.h"
 #include "comp-decision-algo.h"
 
 
+class SimContext;
+
 class FfMacScheduler
 {
 public:
-  FfMacScheduler(CellId cellId);
+  FfMacScheduler(CellId cellId, SimContext &context);
   FfMacScheduler(FfMacScheduler &&scheduler);
   ~FfMacScheduler();
   void setLeader(CellId cellId);
@@ -24,7 +27,14 @@ public:
 
   void onTimeout();
 
+  size_t cellSwitchCount() const { return mlCellSwitchCounter; }
+  Time decisionWindowDuration() const { return mCompAlgo->windowDuration(); }
+
+  void saveState(CheckpointWriter &writer) const;
+  void loadState(CheckpointReader &reader);
+
 private:
+  SimContext &mContext;
   int const mCellId;
   bool mIsLeader;
   int mDirectParticipantCellId;
@@ -40,16 +50,29 @@ private:
 
   UniqCompSchedulingAlgo mCompAlgo;
 
-  void setTimeout(Time when);
-  enum class SchedulerEvent
+  enum class SchedulerEvent : uint8_t
   {
     updateDciDecision
     , startTx
     , stopTx
   };
 
-  std::map<Time, std::queue<SchedulerEvent>> mInternalEvents;
-  std::map<Time, int> mScheduledDirectCellId;
+  //! @brief step of the switch procedure waiting for its time, it carries all its data,
+  //!  so the wakeup resumes it without any lookups
+  struct PendingTransition
+  {
+    Time atTime;
+    SchedulerEvent event;
+    int directCellId; //< of SchedulerEvent::stopTx
+  };
+
+  //! @brief keeps one wakeup at the earliest pending transition
+  void updateWakeup();
+  void enqueueTransition(const PendingTransition &transition);
+
+  //! @brief by time, equal time ones in the enqueueing order
+  std::deque<PendingTransition, ArenaAllocator<PendingTransition>> mPendingTransitions;
+  TimerHandle mWakeup;
   int mLastScheduledCellId;
   Time mLastSwichTime = Converter::milliseconds(0);
 
@@ -1,74 +1,185 @@
 #include "l2-mac.h"
 
+#include <algorithm>
+
 #include "x2-channel.h"
-#include "../simulator.h"
+#include "../sim-context.h"
 
-L2Mac::L2Mac()
+namespace
 {
-  X2Channel::instance()->configurate(compMembersCount);
-  mMacSapUser = new FfMacSchedSapUser;
-  for (int i = 0; i < compMembersCount; i++)
+  double toThroughputKbps(uint64_t bytes, double seconds)
+  {
+    return bytes / 1000.0 * 8 / seconds;
+  }
+
+  //! @brief the trace time as strtod parses it: the start times are whole milliseconds,
+  //!  so the division gives the double nearest to the decimal text of the trace
+  double toSeconds(Time time)
+  {
+    return time / 1e6;
+  }
+}
+
+void ThroughputMeter::add(Time atTime, const DlRlcPacket &packet)
+{
+  const double startTime = toSeconds(atTime);
+  if (!mHasTransmitted)
     {
-      mSchedulers.push_back(FfMacScheduler(i + 1));
-      mSchedulers.back().setFfMacSchedSapUser(mMacSapUser);
+      mFirstTxTime = startTime;
+      mTotal.startTime = startTime;
+      mHasTransmitted = true;
     }
+  mLastTxEndTime = toSeconds(packet.endTime);
+
+  add(mTotal, startTime, packet.rxBytes);
+  // the UEs seen later start their epochs at the first transmission as well
+  auto ue = mUes.insert(std::make_pair(packet.imsi, Epochs {mFirstTxTime, 0, 0, 0})).first;
+  add(ue->second, startTime, packet.rxBytes);
+}
 
-  std::string resultMacLocation = "./output/DlRlcStats.txt";
-  mResultRlcStats.open(resultMacLocation, std::ios_base::out | std::ios_base::trunc);
-  mResultRlcStats << "% start	end	CellId	IMSI	RNTI	LCID	nTxPDUs	TxBytes	nRxPDUs	RxBytes	delay"
-                  << "	stdDev	min	max	PduSize	stdDev	min	max\n";
+void ThroughputMeter::add(Epochs &epochs, double startTime, int rxBytes)
+{
+  epochs.txBytes += rxBytes;
+  if (startTime >= epochs.startTime + epochDuration)
+    {
+      const double throughput = toThroughputKbps(epochs.txBytes - epochs.startTxBytes, startTime - epochs.startTime);
+      epochs.maxThroughputKbps = std::max(epochs.maxThroughputKbps, throughput);
+      epochs.startTime = startTime;
+      epochs.startTxBytes = epochs.txBytes;
+    }
+}
 
-  std::string resultRsrpLocation = "./output/measurements.log";
-  mResultMeasurements.open(resultRsrpLocation, std::ios_base::out | std::ios_base::trunc);
-  mResultMeasurements << "% time[usec]	srcCellId	targetCellId	RSRP\n";
+double ThroughputMeter::averageKbps(const Epochs &epochs) const
+{
+  if (!mHasTransmitted || mLastTxEndTime <= mFirstTxTime)
+    return 0.0;
+  return toThroughputKbps(epochs.txBytes, mLastTxEndTime - mFirstTxTime);
+}
 
+std::vector<UeThroughput> ThroughputMeter::ueThroughputs() const
+{
+  std::vector<UeThroughput> result;
+  for (const auto &ue : mUes)
+    result.push_back({ue.first, averageKbps(ue.second), ue.second.maxThroughputKbps});
+  return result;
+}
+
+void ThroughputMeter::saveState(CheckpointWriter &writer) const
+{
+  writer.write(mHasTransmitted);
+  writer.write(mFirstTxTime);
+  writer.write(mLastTxEndTime);
+  writer.write(mTotal);
+  writer.write(mUes);
+}
+
+void ThroughputMeter::loadState(CheckpointReader &reader)
+{
+  reader.read(mHasTransmitted);
+  reader.read(mFirstTxTime);
+  reader.read(mLastTxEndTime);
+  reader.read(mTotal);
+  reader.read(mUes);
+}
+
+void logThroughput(const MacStatistics &statistics)
+{
+  LOG("DlThroughput (RLC) [Kbps]:");
+  for (const UeThroughput &ue : statistics.ueThroughputs)
+    {
+      LOG("\tIMSI = " << ue.imsi << "\tave: " << ue.aveThroughputKbps << "\tmax: " << ue.maxThroughputKbps);
+    }
+  LOG("\tall UEs\tave: " << statistics.aveThroughputKbps << "\tmax: " << statistics.maxThroughputKbps << "\n");
+}
+
+L2Mac::L2Mac(SimContext &context, CellId localCell)
+  : mContext(context)
+  , mLocalCell(localCell)
+  , mResultRlcStats(SimConfig::rlcOutputMode == SimConfig::rlcTextOutput && context.hasOutputs()
+                    ? &context.outputFile("DlRlcStats.txt", RlcLineTable::header) : nullptr)
+  , mSelectsTransmitted(SimConfig::rlcOutputMode == SimConfig::rlcSelectionOutput
+                        || (SimConfig::rlcOutputMode == SimConfig::rlcNoOutput && localCell != -1))
+  , mResultMeasurements(context.outputFile("measurements.log", "% time[usec]	srcCellId	targetCellId	RSRP\n"))
+{
+  mContext.x2Channel().configurate(compMembersCount);
+  mMacSapUser = new FfMacSchedSapUser(mContext);
+  mSubframeDciReads.resize(compMembersCount + 1);
+  mSubframeDciDecisions.resize(compMembersCount + 1);
+  for (int cellId = 0; cellId <= compMembersCount; cellId++)
+    mReportMeasurementNames.push_back("recvMeasurementsReport" + std::to_string(cellId));
+  for (int i = 0; i < compMembersCount; i++)
+    {
+      mSchedulers.push_back(FfMacScheduler(i + 1, mContext));
+      mSchedulers.back().setFfMacSchedSapUser(mMacSapUser);
+    }
 }
 
 L2Mac::~L2Mac()
 {
   delete mMacSapUser;
-  mResultRlcStats.flush();
-  mResultRlcStats.close();
-
+  if (mResultRlcStats)
+    mResultRlcStats->flush();
   mResultMeasurements.flush();
-  mResultMeasurements.close();
 
   printMacTimings();
-  LOG("Not used timeframes: " << mMissedFrameCounter << "\t(about " << mMissedFrameCounter / 1000.0 << " [s])\n");
+  if (mLocalCell == -1)
+    {
+      LOG("Not used timeframes: " << mMissedFrameCounter << "\t(about " << mMissedFrameCounter / 1000.0 << " [s])\n");
+      logThroughput(statistics());
+    }
 }
 
 void L2Mac::activateDlCompFeature()
 {
-  mSchedulers.front().setLeader(true);
-  mSchedulers.front().setCompGroup({1, 2, 3});
-
-  l2Timeout(-1);
+  if (isLocal(1))
+    {
+      mSchedulers.front().setLeader(true);
+      mSchedulers.front().setCompGroup({1, 2, 3});
+    }
 }
 
-void L2Mac::makeScheduleDecision(int cellId, const DlRlcPacket &packet)
+void L2Mac::makeScheduleDecisions(const std::vector<Event> &attempts)
 {
-  static Time subframeTime = Converter::milliseconds(0);
-  const Time curTime = SimTimeProvider::getTime();
-  if (curTime > subframeTime)
+  const Time curTime = mContext.getTime();
+  if (curTime > mSubframeTime && mLocalCell == -1)
     {
       if (mMacSapUser->getDirectCellId() == -1)
         {
           mMissedFrameCounter += 1;
-          LOG(">" << subframeTime << "  frame miss");
+          LOG(">" << mSubframeTime << "  frame miss");
         }
-      subframeTime = curTime;
+      mSubframeTime = curTime;
     }
 
-
-  if (mMacSapUser->getDciDecision(cellId))
+  // the first read within a subframe may drop the decision that was in effect,
+  // all the next reads see the same state, see FfMacSchedSapUser::getDciDecision
+  std::fill(mSubframeDciReads.begin(), mSubframeDciReads.end(), 0);
+  for (const Event &attempt : attempts)
     {
-      mResultRlcStats << packet.dlRlcStatLine << "\n";
+      const int cellId = attempt.cellId;
+      if (mSubframeDciReads[cellId] < 2)
+        {
+          mSubframeDciDecisions[cellId] = mMacSapUser->getDciDecision(cellId);
+          ++mSubframeDciReads[cellId];
+        }
+
+      if (mSubframeDciDecisions[cellId])
+        {
+          // the lines of a compressed trace are written from the selection at the end
+          if (mResultRlcStats && !mContext.rlcLines().isCompressed())
+            mContext.rlcLines().write(*mResultRlcStats, attempt.packet.index);
+          else if ((mResultRlcStats || mSelectsTransmitted) && !mContext.outputsMuted())
+            mTransmitted.select(attempt.packet.index);
+          // as the output DlRlcStats.txt the throughput has no warm-up traffic
+          if (!mContext.outputsMuted())
+            mThroughput.add(attempt.atTime, attempt.packet);
+        }
     }
 }
 
 void L2Mac::recvMeasurementsReport(int cellId, const CSIMeasurementReport &report)
 {
-  const std::string fname = "recvMeasurementsReport" + std::to_string(cellId);
+  const std::string &fname = mReportMeasurementNames[cellId];
   mTimeMeasurement.start(fname);
 
   mSchedulers[cellId - 1].schedDlCqiInfoReq(report.targetCellId, report.csi);
@@ -107,26 +218,66 @@ void L2Mac::recvX2Message(int cellId, const X2Message &message)
 
 void L2Mac::l2Timeout(int cellId)
 {
-  size_t begin = 1;
-  size_t end = mSchedulers.size();
-  if (cellId >= 0)
-    {
-      begin = cellId;
-      end = begin + 1;
-    }
+  // the scheduler wakes up at its own deadlines only, a cancelled wakeup finds no timers
+  if (isLocal(cellId) && mContext.timers().expire(cellId, mContext.getTime()))
+    mSchedulers[cellId - 1].onTimeout();
+}
 
-  for (size_t i = begin; i < end; i++)
+void L2Mac::dispatch(const Event &event)
+{
+  switch (event.eventType)
     {
-      mSchedulers[i - 1].onTimeout();
+    case EventType::x2Message:
+      recvX2Message(event.cellId, event.message);
+      break;
+    case EventType::csiIndicator:
+      recvMeasurementsReport(event.cellId, event.report);
+      break;
+    case EventType::l2Timeout:
+      l2Timeout(event.cellId);
+      break;
+    case EventType::scheduleAttempt:
+    case EventType::stopSimulation:
+      break;
     }
+}
 
-  if (cellId == -1)
-    {
-      Event event { EventType::l2Timeout, SimTimeProvider::getTime() + Converter::microseconds(999) };
-      event.cellId = -1;
-      Simulator::instance()->scheduleEvent(event);
-    }
+bool L2Mac::peekDirectDecision(CellId cellId)
+{
+  const bool peek = true;
+  return mMacSapUser->getDciDecision(cellId, peek);
+}
 
+MacStatistics L2Mac::statistics() const
+{
+  MacStatistics result;
+  result.aveThroughputKbps = mThroughput.averageKbps();
+  result.maxThroughputKbps = mThroughput.maximumKbps();
+  result.ueThroughputs = mThroughput.ueThroughputs();
+  for (const FfMacScheduler &scheduler : mSchedulers)
+    result.cellSwitches += scheduler.cellSwitchCount();
+  result.missedFrames = mMissedFrameCounter;
+  return result;
+}
+
+void L2Mac::saveState(CheckpointWriter &writer) const
+{
+  mMacSapUser->saveState(writer);
+  for (const FfMacScheduler &scheduler : mSchedulers)
+    scheduler.saveState(writer);
+  writer.write(mMissedFrameCounter);
+  writer.write(mSubframeTime);
+  mThroughput.saveState(writer);
+}
+
+void L2Mac::loadState(CheckpointReader &reader)
+{
+  mMacSapUser->loadState(reader);
+  for (FfMacScheduler &scheduler : mSchedulers)
+    scheduler.loadState(reader);
+  reader.read(mMissedFrameCounter);
+  reader.read(mSubframeTime);
+  mThroughput.loadState(reader);
 }
 
 void L2Mac::printMacTimings()
@@ -135,6 +286,8 @@ void L2Mac::printMacTimings()
   LOG("\tScheduler decisions timings [us]:");
   for (int i = 0; i < compMembersCount; i++)
     {
+      if (!isLocal(i + 1))
+        continue;
       const std::string index = "recvMeasurementsReport" + std::to_string(i + 1);
       LOG("\tcellId = " << i + 1
           << "\tave: " << mTimeMeasurement.average(index) << "\tmin: "<< mTimeMeasurement.minimum(index)
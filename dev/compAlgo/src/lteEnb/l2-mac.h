@@ -3,38 +3,134 @@
 #include <string>
 #include <vector>
 #include <fstream>
+#include <map>
 
 #include "../helpers.h"
+#include "../packet-selection.h"
 #include "ff-mac-scheduler.h"
 #include "ff-mac-sched-sap.h"
 
+class SimContext;
+
+//! @brief throughput of one UE as throughputCalc.py gives
+struct UeThroughput
+{
+  int imsi;
+  double aveThroughputKbps;
+  double maxThroughputKbps; //< over 200 ms epochs
+};
+
+//! @brief summary of one run, the throughput is of all UEs together as throughputCalc.py --ignore-imsi gives
+struct MacStatistics
+{
+  double aveThroughputKbps = 0;
+  double maxThroughputKbps = 0; //< over 200 ms epochs
+  std::vector<UeThroughput> ueThroughputs; //< by IMSI
+  size_t cellSwitches = 0;
+  size_t missedFrames = 0;
+};
+
+//! @brief logs the throughput of the run as throughputCalc.py prints it
+void logThroughput(const MacStatistics &statistics);
+
+//! @class ThroughputMeter sums up the transmitted RLC traffic over 200 ms epochs the way throughputCalc.py does
+//!  with the output DlRlcStats.txt, of all UEs together as with --ignore-imsi and of every UE
+//! @brief the epochs of every UE and the averages are timed from the first transmission of any UE, as in the script.
+//!  The epoch bounds are compared in double seconds as the script does with the trace times, so an epoch
+//!  closes on the same line, e.g. 0.6 is before 0.4 + 0.2.
+class ThroughputMeter
+{
+public:
+  void add(Time atTime, const DlRlcPacket &packet);
+
+  double averageKbps() const { return averageKbps(mTotal); }
+  double maximumKbps() const { return mTotal.maxThroughputKbps; } //< over epochs
+  std::vector<UeThroughput> ueThroughputs() const;
+
+  void saveState(CheckpointWriter &writer) const;
+  void loadState(CheckpointReader &reader);
+
+private:
+  struct Epochs
+  {
+    double startTime; //< [s]
+    uint64_t txBytes;
+    uint64_t startTxBytes;
+    double maxThroughputKbps;
+  };
+
+  const double epochDuration = .200; //< [s]
+  bool mHasTransmitted = false;
+  double mFirstTxTime = 0; //< [s]
+  double mLastTxEndTime = 0; //< [s]
+  Epochs mTotal {};
+  std::map<int, Epochs> mUes; //< by IMSI
+
+  void add(Epochs &epochs, double startTime, int rxBytes);
+  double averageKbps(const Epochs &epochs) const;
+};
+
 class L2Mac
 {
 public:
-  L2Mac();
+  //! @arg localCell the only cell to run or -1 for the whole CoMP group.
+  //!  With a single local cell the frame-miss check is left to the caller, see PartitionedSimulator.
+  L2Mac(SimContext &context, CellId localCell = -1);
   ~L2Mac();
 
   void activateDlCompFeature();
 
-  void makeScheduleDecision(int cellId, const DlRlcPacket &packet);
+  //! @brief all schedule attempts of one subframe
+  void makeScheduleDecisions(const std::vector<Event> &attempts);
   void recvMeasurementsReport(int cellId, const CSIMeasurementReport &report);
   void recvX2Message(int cellId, const X2Message &message);
   void l2Timeout(int cellId);
+  //! @brief any event but EventType::scheduleAttempt and EventType::stopSimulation
+  void dispatch(const Event &event);
+
+  int cellsCount() const { return compMembersCount; }
+  //! @brief DCI decision of the cell as the frame-miss check sees it at the current time
+  bool peekDirectDecision(CellId cellId);
+
+  MacStatistics statistics() const;
+  //! @brief packets transmitted out of the muted periods, kept in SimConfig::rlcSelectionOutput mode,
+  //!  in SimConfig::rlcTextOutput mode if the RLC trace is compressed and in SimConfig::rlcNoOutput mode
+  //!  for a single local cell, PartitionedSimulator takes the throughput from them
+  const PacketSelection& transmitted() const { return mTransmitted; }
+  //! @brief trace time to replay before the decisions are meaningful:
+  //!  the CSI journals fill in one decision window, the indicator journals made of them in another one
+  Time warmUpDuration() const { return 2 * mSchedulers.front().decisionWindowDuration(); }
+
+  //! @brief state of the schedulers and of the MAC itself, the event queue is kept by Simulator
+  void saveState(CheckpointWriter &writer) const;
+  void loadState(CheckpointReader &reader);
 
 private:
+  SimContext &mContext;
+  const CellId mLocalCell;
   FfMacSchedSapUser *mMacSapUser;
 
   const int compMembersCount = 3;
 
   std::vector<FfMacScheduler> mSchedulers;
   TimeMeasurement mTimeMeasurement;
-  std::fstream mResultRlcStats;
-  std::fstream mResultMeasurements;
+  std::vector<std::string> mReportMeasurementNames; //< per cellId, not built for every report
+  std::ostream *mResultRlcStats; //< nullptr if the text RLC output is not written
+  const bool mSelectsTransmitted; //< without the text output, see transmitted()
+  std::ostream &mResultMeasurements;
+  PacketSelection mTransmitted;
   size_t mMissedFrameCounter = 0;
+  Time mSubframeTime = Converter::milliseconds(0);
+
+  std::vector<int> mSubframeDciReads;        //< per cellId
+  std::vector<bool> mSubframeDciDecisions;   //< per cellId
+
+  ThroughputMeter mThroughput;
 
   L2Mac(const L2Mac &) = delete;
   L2Mac& operator=(const L2Mac &) = delete;
 
+  bool isLocal(CellId cellId) const { return mLocalCell == -1 || mLocalCell == cellId; }
   void printMacTimings();
 };
 
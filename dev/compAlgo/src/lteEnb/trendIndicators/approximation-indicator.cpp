@@ -35,26 +35,33 @@ namespace
   }
 }
 
-ApproximationIndicator::ApproximationIndicator(CsiJournalPtr j, Method type)
+ApproximationIndicator::ApproximationIndicator(CsiJournalPtr j, const AlgoConfig &config, Method type)
   : ITrendIndicator("approximation-ind", j)
   , mApproximationType(type)
 {
-  switch (SimConfig::algoType)
+  const int xOffset = config.approxAlgoXOffset;
+  switch (config.algoType)
     {
     case SimConfig::chebyshevApprx:
       mApproximationType = chebyshevPolynomials;
-      mCalcApprxFunc = calcChebyshev;
+      mCalcApprxFunc = [xOffset] (const CsiArray &csiArray, int64_t lPointer)
+      {
+        return calcChebyshev(csiArray, lPointer, xOffset);
+      };
       break;
     case SimConfig::leastSquaresRegression:
       mApproximationType = polyRegressionFitting;
-      mCalcApprxFunc = calcPolyRegression;
+      mCalcApprxFunc = [xOffset] (const CsiArray &csiArray, int64_t lPointer)
+      {
+        return calcPolyRegression(csiArray, lPointer, xOffset);
+      };
       break;
     default:
       DEBUG2("Other indicator in use. Makeing stub..");
       mCalcApprxFunc = [] (const CsiArray &, int64_t) -> double { return 0.0; };
       return;
     }
-  mWindowSize = SimConfig::approxAlgoWindowSize;
+  mWindowSize = config.approxAlgoWindowSize;
 }
 
 double ApproximationIndicator::updateHook(CellId cellId)
@@ -62,7 +69,7 @@ double ApproximationIndicator::updateHook(CellId cellId)
   return forecast(cellId);
 }
 
-double ApproximationIndicator::calcChebyshev(const CsiArray &csiArray, int64_t lPointer)
+double ApproximationIndicator::calcChebyshev(const CsiArray &csiArray, int64_t lPointer, int xOffset)
 {
   const auto dataSize = csiArray.size();
   assert(dataSize);
@@ -79,23 +86,23 @@ double ApproximationIndicator::calcChebyshev(const CsiArray &csiArray, int64_t l
 
   gsl_cheb_init (chebSeries, &gslFunction, csiArray[lPointer].first, csiArray.back().first);
 
-  const double x = csiArray.back().first + SimConfig::approxAlgoXOffset;
+  const double x = csiArray.back().first + xOffset;
 
   double result = gsl_cheb_eval (chebSeries, x);
   gsl_cheb_free (chebSeries);
   return result;
 }
 
-double ApproximationIndicator::calcPolyRegression(const CsiArray &csiArray, int64_t lPointer)
+double ApproximationIndicator::calcPolyRegression(const CsiArray &csiArray, int64_t lPointer, int xOffset)
 {
   const int64_t dataSize = csiArray.size();
 
-  static int64_t eqOne = 0;
-  static int64_t eqElse = 0;
+  static thread_local int64_t eqOne = 0;
+  static thread_local int64_t eqElse = 0;
   if (dataSize == 1)
     {
       DEBUG("win size: "<< ++eqOne << "\t" << eqElse);
-      return calcChebyshev(csiArray, lPointer);
+      return calcChebyshev(csiArray, lPointer, xOffset);
     }
   else
     DEBUG("win size: "<< eqOne << "\t" << ++eqElse);
@@ -140,7 +147,7 @@ double ApproximationIndicator::calcPolyRegression(const CsiArray &csiArray, int6
   const auto slope = gsl_vector_get(coeff, 1);
   // Y = intecept + slope * x
 
-  const double x = csiArray.back().first + SimConfig::approxAlgoXOffset;
+  const double x = csiArray.back().first + xOffset;
 
   gsl_matrix_free (Xmatrix);
   gsl_vector_free (xset);
@@ -13,7 +13,7 @@ public:
   };
 
 
-  ApproximationIndicator(CsiJournalPtr j, Method type = fromConfig);
+  ApproximationIndicator(CsiJournalPtr j, const AlgoConfig &config, Method type = fromConfig);
 
 
   double forecast(CellId cellId);
@@ -26,9 +26,9 @@ protected:
   double forecastLagrange(CellId cellId);
 
   //! approximation by chebyshev polynomials
-  static double calcChebyshev(const CsiArray &csiArray, int64_t lPointer);
+  static double calcChebyshev(const CsiArray &csiArray, int64_t lPointer, int xOffset);
   //! @brief polynomial least-square method
-  static double calcPolyRegression(const CsiArray &csiArray, int64_t lPointer);
+  static double calcPolyRegression(const CsiArray &csiArray, int64_t lPointer, int xOffset);
 
   std::function<double (const CsiArray&, int64_t)> mCalcApprxFunc;
 
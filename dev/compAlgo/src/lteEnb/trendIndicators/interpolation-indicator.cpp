@@ -1,10 +1,11 @@
 #include "interpolation-indicator.h"
 
-InterpolationIndicator::InterpolationIndicator(CsiJournalPtr j, Method type)
+InterpolationIndicator::InterpolationIndicator(CsiJournalPtr j, const AlgoConfig &config, Method type)
   : ITrendIndicator("interpolation-ind", j)
   , mInterpolationType(type)
+  , mXOffset(config.approxAlgoXOffset)
 {
-  mWindowSize = SimConfig::approxAlgoWindowSize;
+  mWindowSize = config.approxAlgoWindowSize;
 }
 
 double InterpolationIndicator::updateHook(CellId cellId)
@@ -25,7 +26,7 @@ double InterpolationIndicator::forecastLagrange(CellId cellId)
   if (dataSize > 2)
     x = 0.5 * (x + data[dataSize - 2].first - data[dataSize - 3].first);
 
-  x = data.back().first + SimConfig::approxAlgoXOffset;
+  x = data.back().first + mXOffset;
 
   double result = 0.0;
   for (auto j = left; j < dataSize; j++)
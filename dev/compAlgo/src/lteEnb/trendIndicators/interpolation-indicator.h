@@ -10,13 +10,14 @@ public:
     lagrangePolynomials
   };
 
-  InterpolationIndicator(CsiJournalPtr j, Method type = lagrangePolynomials);
+  InterpolationIndicator(CsiJournalPtr j, const AlgoConfig &config, Method type = lagrangePolynomials);
 
 
   double forecast(CellId cellId);
 
 protected:
   Method mInterpolationType;
+  const int mXOffset;
 
   double updateHook(CellId cellId);
 
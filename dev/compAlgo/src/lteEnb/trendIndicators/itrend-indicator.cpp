@@ -17,6 +17,35 @@ ITrendIndicator::~ITrendIndicator()
     }
 }
 
+void ITrendIndicator::saveState(CheckpointWriter &writer) const
+{
+  writer.write(mApplyAnalysOnForecast);
+  writer.write(mIsShadowValueUsed);
+  writer.write(mWeightedSignals);
+  writer.write(mSignalDiffs);
+  writer.write(mWValuesDiffs);
+  writer.write(mLastPrediction);
+  mErrorStats.saveState(writer);
+  writer.write(bool(mWindowDuration && mWindowSize));
+}
+
+void ITrendIndicator::loadState(CheckpointReader &reader)
+{
+  reader.read(mApplyAnalysOnForecast);
+  reader.read(mIsShadowValueUsed);
+  reader.read(mWeightedSignals);
+  reader.read(mSignalDiffs);
+  reader.read(mWValuesDiffs);
+  reader.read(mLastPrediction);
+  mErrorStats.loadState(reader);
+
+  // duration based window gets its size on the first update
+  bool isWindowSizeDerived = false;
+  reader.read(isWindowSizeDerived);
+  if (isWindowSizeDerived && mWindowDuration)
+    mWindowSize = mWindowDuration / measuremetnsInterval + 1;
+}
+
 void ITrendIndicator::update(CellId cellId)
 {
   if (mIsShadowValueUsed)
@@ -181,7 +210,10 @@ void ITrendIndicator::updateSignalDiffs(CellId cellId)
   auto &array = mCsiJournal->at(cellId);
   const auto size = array.size();
   if (size <= 1)
-    mSignalDiffs[cellId].push_back(0);
+    {
+      mSignalDiffs[cellId].push_back(0);
+      return;
+    }
 
   mSignalDiffs[cellId].push_back(array[size - 1].second - array[size - 2].second);
 }
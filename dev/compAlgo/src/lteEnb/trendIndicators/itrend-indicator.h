@@ -30,6 +30,10 @@ public:
   Time windowDuration() const;
   size_t windowSize() const;
 
+  //! @note the window is not kept, it comes from AlgoConfig of the restoring simulation
+  virtual void saveState(CheckpointWriter &writer) const;
+  virtual void loadState(CheckpointReader &reader);
+
 protected:
   const double crossHysteresis = 0.2;
   const Time measuremetnsInterval = Converter::milliseconds(SimConfig::timeInterval);
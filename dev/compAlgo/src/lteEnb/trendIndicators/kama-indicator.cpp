@@ -3,12 +3,28 @@
 #include <math.h>
 #include <algorithm>
 
-KamaIndicator::KamaIndicator(CsiJournalPtr j)
+KamaIndicator::KamaIndicator(CsiJournalPtr j, const AlgoConfig &config)
   : ITrendIndicator("kama-ind", j)
+  , n(config.kamaN)
+  , f(config.kamaF)
+  , s(config.kamaS)
 {
     mWindowSize = std::max(n, s) + 1; // at start
 }
 
+void KamaIndicator::saveState(CheckpointWriter &writer) const
+{
+  ITrendIndicator::saveState(writer);
+  writer.write(mLatestEfficiencyRatio);
+  writer.write(mLatestFilter);
+}
+
+void KamaIndicator::loadState(CheckpointReader &reader)
+{
+  ITrendIndicator::loadState(reader);
+  reader.read(mLatestEfficiencyRatio);
+  reader.read(mLatestFilter);
+}
 
 double KamaIndicator::updateHook(CellId cellId)
 {
@@ -28,8 +44,8 @@ double KamaIndicator::calcAMA(const CsiArray &csiArray, CellId cellId)
   // volatility
   const int realCount = closeSize - left - 1;
   int volatility = 0;
-  for (int i = 0; i < realCount - 1; i++)
-    volatility += std::abs(csiArray[closeSize - i].second - csiArray[closeSize - i - 1].second);
+  for (int i = 0; i < realCount; i++)
+    volatility += std::abs(csiArray[closeSize - i - 1].second - csiArray[closeSize - i - 2].second);
 
 
   mLatestEfficiencyRatio = (volatility)? double(direction) / volatility : 1;
@@ -6,7 +6,7 @@
 class KamaIndicator : public ITrendIndicator
 {
 public:
-  KamaIndicator(CsiJournalPtr j);
+  KamaIndicator(CsiJournalPtr j, const AlgoConfig &config);
 
   //! @brief efficiencyRatio shows either market is more volatile or trend
   //! @return ER = 0 if absolutely volatile, 1 for stable situation
@@ -15,10 +15,13 @@ public:
   bool isUpgoingTrend(CellId cellId) override;
   bool isDescendingTrend(CellId cellId) override;
 
+  void saveState(CheckpointWriter &writer) const override;
+  void loadState(CheckpointReader &reader) override;
+
 private:
-  const int n = SimConfig::kamaN; // window size for efficincy ratio calculation
-  const int f = SimConfig::kamaF; // window for fast moving average
-  const int s = SimConfig::kamaS; // window for slow MA
+  const int n; // window size for efficincy ratio calculation
+  const int f; // window for fast moving average
+  const int s; // window for slow MA
 
   double mLatestEfficiencyRatio = 1;
   double mLatestFilter = 0;
@@ -2,11 +2,11 @@
 
 #include <algorithm>
 
-WmaIndicator::WmaIndicator(CsiJournalPtr j)
+WmaIndicator::WmaIndicator(CsiJournalPtr j, const AlgoConfig &config)
   : ITrendIndicator("wma-ind", j)
 {
 
-  switch (SimConfig::algoType)
+  switch (config.algoType)
     {
     case SimConfig::smmRaw:
       mCalcMaFunc = calcSMM;
@@ -14,7 +14,7 @@ WmaIndicator::WmaIndicator(CsiJournalPtr j)
     default:
       mCalcMaFunc = calcWMA;
     }
-  mWindowDuration = Converter::milliseconds(SimConfig::wmaSmmDuration);
+  mWindowDuration = Converter::milliseconds(config.wmaSmmDuration);
 }
 
 
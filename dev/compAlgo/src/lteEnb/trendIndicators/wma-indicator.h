@@ -12,7 +12,7 @@ public:
 
   };
 
-  WmaIndicator(CsiJournalPtr j);
+  WmaIndicator(CsiJournalPtr j, const AlgoConfig &config);
 
   bool isLastOutlier(CellId cellId, size_t lPointer = 0);
 
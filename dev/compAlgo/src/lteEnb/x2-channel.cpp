@@ -1,20 +1,11 @@
 #include "x2-channel.h"
 
-#include "../simulator.h"
+#include "../sim-context.h"
 
-X2Channel* X2Channel::mInstance = nullptr;
-
-X2Channel *X2Channel::instance()
+X2Channel::X2Channel(SimContext &context)
+  : mContext(context)
+  , mLastSentTime(context.arena())
 {
-  if (!mInstance)
-    mInstance = new X2Channel;
-  return mInstance;
-}
-
-void X2Channel::destroy()
-{
-  delete mInstance;
-  mInstance = nullptr;
 }
 
 void X2Channel::configurate(int compGroupSize)
@@ -39,17 +30,16 @@ void X2Channel::send(int tCellId, X2Message msg)
 
   for (int i = beginMulticastId; i < endMulticastId; i++)
     {
-      const Time constArrivalPart = SimTimeProvider::getTime() + getLatency();
-      Time variativePart = Converter::microseconds(tCellId);
-
-      if (constArrivalPart + variativePart == mLastSentTime[tCellId])
-        variativePart += Converter::microseconds(1);
-      mLastSentTime[tCellId] = constArrivalPart + variativePart;
+      const Time constArrivalPart = mContext.getTime() + getLatency();
+      const Time variativePart = Converter::microseconds(tCellId);
+      Time arrival = constArrivalPart + variativePart;
+      if (!mIsTieBreakDeferred)
+        arrival = tieBreak(mLastSentTime, tCellId, arrival);
 
-      Event msgEvent(EventType::x2Message, constArrivalPart + variativePart);
+      Event msgEvent(EventType::x2Message, arrival);
       msgEvent.cellId = i;
       msgEvent.message = msg;
-      Simulator::instance()->scheduleEvent(msgEvent);
+      mContext.scheduleEvent(msgEvent);
     }
 }
 
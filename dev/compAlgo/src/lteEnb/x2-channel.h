@@ -1,28 +1,54 @@
 #pragma once
 
 #include "../helpers.h"
+#include "../memory-arena.h"
 #include <map>
 
+class SimContext;
+
 class X2Channel
 {
 public:
-  static X2Channel* instance();
-  static void destroy();
+  X2Channel(SimContext &context);
   void configurate(int compGroupSize);
 
   Time getLatency() const;
+  //! @brief every message arrives this long after it is sent or later, a multicast one microsecond
+  //!  before getLatency(). The lookahead of PartitionedSimulator.
+  Time minimalLatency() const { return delay - Converter::microseconds(1); }
 
+  //! @arg tCellId -1 to send to all the group
   void send(int tCellId, X2Message msg);
 
+  //! @brief the messages leave with their unshifted arrival times, the caller shifts the equal ones apart
+  //!  with tieBreak() in the order of the sends, see PartitionedSimulator::deliverMessages
+  void deferTieBreak() { mIsTieBreakDeferred = true; }
+  //! @return tCellId of send() of the message with its unshifted arrival time
+  int targetOf(const Event &message, Time sentTime) const { return message.atTime - sentTime - getLatency(); }
+  //! @brief shifts the arrival by a microsecond if it equals the one of the last message sent with tCellId
+  //! @arg lastSentTimes by tCellId
+  template <typename Map>
+  static Time tieBreak(Map &lastSentTimes, int tCellId, Time arrival)
+  {
+    Time &lastSentTime = lastSentTimes[tCellId];
+    if (arrival == lastSentTime)
+      arrival += Converter::microseconds(1);
+    lastSentTime = arrival;
+    return arrival;
+  }
+
+  void saveState(CheckpointWriter &writer) const { writer.write(mLastSentTime); }
+  void loadState(CheckpointReader &reader) { reader.read(mLastSentTime); }
+
 
 private:
+  SimContext &mContext;
   int mCompGroupSize = 0;
   const Time delay = Converter::milliseconds(2);
+  bool mIsTieBreakDeferred = false;
 
-  static X2Channel* mInstance;
+  std::map<int, Time, std::less<int>, ArenaAllocator<std::pair<const int, Time>>> mLastSentTime; //< by tCellId
 
-  std::map<int, Time> mLastSentTime;
-
-  X2Channel() = default;
+  X2Channel(const X2Channel &) = delete;
+  X2Channel& operator =(const X2Channel &) = delete;
 };
-
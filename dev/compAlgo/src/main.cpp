@@ -1,12 +1,120 @@
 #include "simulator.h"
+#include "sweep-runner.h"
+#include "partitioned-simulator.h"
 
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <thread>
 
-int main()
+namespace
 {
-  Simulator::instance()->run();
+  void usage()
+  {
+    std::cout << "Usage:  compAlgo [--from <time [ms]>] [--to <time [ms]>]\n"
+              << "                 [--checkpoint <time [ms]> <checkpoint file> | --restore <checkpoint file>]\n"
+              << "        compAlgo --sweep <grid file> [threads count]\n"
+              << "        compAlgo --partition [threads count]\n";
+  }
 
-  Simulator::destroy();
+  //! @return false if the text is not a whole non-negative number
+  bool parseCount(const char *text, uint64_t &value)
+  {
+    char *end = nullptr;
+    errno = 0;
+    value = strtoull(text, &end, 10);
+    return *text >= '0' && *text <= '9' && end != text && !*end && errno != ERANGE;
+  }
 
-  return 0;
+  bool parseMilliseconds(const char *text, Time &time)
+  {
+    uint64_t milliseconds = 0;
+    if (!parseCount(text, milliseconds) || milliseconds > std::numeric_limits<Time>::max() / 1000)
+      return false;
+    time = Converter::milliseconds(milliseconds);
+    return true;
+  }
 }
 
+//! usage: see usage()
+int main(int argc, char *argv[])
+{
+  const std::string inputDir = "./input/" + std::to_string(SimConfig::traceInterval);
+  const std::string outputDir = "./output";
+
+  if (argc > 2 && !strcmp(argv[1], "--sweep"))
+    {
+      uint64_t threadsCount = 0;
+      if (argc > 3 && !parseCount(argv[3], threadsCount))
+        {
+          usage();
+          return 1;
+        }
+      SweepRunner sweep(inputDir, outputDir);
+      sweep.loadGrid(argv[2]);
+      sweep.run(threadsCount);
+      return 0;
+    }
+
+  if (argc > 1 && !strcmp(argv[1], "--partition"))
+    {
+      uint64_t threadsCount = std::thread::hardware_concurrency();
+      if (argc > 2 && (!parseCount(argv[2], threadsCount) || !threadsCount))
+        {
+          usage();
+          return 1;
+        }
+      RlcLinesPtr rlcLines;
+      if (SimConfig::rlcOutputMode == SimConfig::rlcTextOutput)
+        rlcLines.reset(new RlcLineTable(inputDir + "/DlRlcStats.txt"));
+      TraceBufferPtr traces(new TraceBuffer(*MergedTraceCursor::openScenario(inputDir, 0, threadsCount), rlcLines));
+      PartitionedSimulator simulator(traces, outputDir, threadsCount);
+      simulator.run();
+      return 0;
+    }
+
+  Time replayFrom = 0;
+  Time replayTo = std::numeric_limits<Time>::max();
+  std::string checkpointLocation, restoreLocation;
+  Time checkpointTime = 0;
+  for (int i = 1; i < argc; ++i)
+    {
+      const char *option = argv[i];
+      bool isValid = true;
+      if (i + 1 < argc && !strcmp(argv[i], "--from"))
+        isValid = parseMilliseconds(argv[++i], replayFrom);
+      else if (i + 1 < argc && !strcmp(argv[i], "--to"))
+        isValid = parseMilliseconds(argv[++i], replayTo);
+      else if (i + 2 < argc && !strcmp(argv[i], "--checkpoint"))
+        {
+          isValid = parseMilliseconds(argv[++i], checkpointTime);
+          checkpointLocation = argv[++i];
+        }
+      else if (i + 1 < argc && !strcmp(argv[i], "--restore"))
+        restoreLocation = argv[++i];
+      else
+        isValid = false;
+
+      if (!isValid)
+        {
+          std::cerr << "invalid option " << option << "\n";
+          usage();
+          return 1;
+        }
+    }
+  if (replayFrom >= replayTo)
+    {
+      std::cerr << "--from must be before --to\n";
+      usage();
+      return 1;
+    }
+
+  Simulator simulator(inputDir, outputDir, replayFrom, replayTo);
+  if (!checkpointLocation.empty())
+    simulator.setCheckpoint(checkpointTime, checkpointLocation);
+  if (!restoreLocation.empty())
+    simulator.restore(restoreLocation);
+  simulator.run();
+
+  return 0;
+}
@@ -0,0 +1,38 @@
+#include "mapped-file.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+MappedFile::MappedFile(const std::string &location)
+{
+  const int fd = open(location.c_str(), O_RDONLY);
+  if (fd < 0)
+    return;
+
+  struct stat info;
+  if (fstat(fd, &info) == 0)
+    {
+      mSize = info.st_size;
+      if (!mSize)
+        mIsOpen = true;
+      else
+        {
+          void *data = mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, fd, 0);
+          if (data != MAP_FAILED)
+            {
+              madvise(data, mSize, MADV_SEQUENTIAL);
+              mData = static_cast<const char*>(data);
+              mIsOpen = true;
+            }
+        }
+    }
+  close(fd); // the mapping stays valid
+}
+
+MappedFile::~MappedFile()
+{
+  if (mData)
+    munmap(const_cast<char*>(mData), mSize);
+}
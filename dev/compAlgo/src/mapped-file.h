@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+
+//! @class MappedFile maps a whole file read-only into the memory, the pages are read on demand
+class MappedFile
+{
+public:
+  explicit MappedFile(const std::string &location);
+  ~MappedFile();
+
+  bool isOpen() const { return mIsOpen; }
+  //! @note nullptr for an empty file
+  const char* data() const { return mData; }
+  size_t size() const { return mSize; }
+
+private:
+  const char *mData = nullptr;
+  size_t mSize = 0;
+  bool mIsOpen = false;
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile& operator =(const MappedFile &) = delete;
+};
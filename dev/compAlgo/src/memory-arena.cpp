@@ -0,0 +1,58 @@
+#include "memory-arena.h"
+
+#include <new>
+
+constexpr size_t MemoryArena::blockAlignment;
+constexpr size_t MemoryArena::maxBlockSize;
+constexpr size_t MemoryArena::chunkSize;
+constexpr size_t MemoryArena::classesCount;
+
+void* MemoryArena::allocate(size_t bytes)
+{
+  ++mAllocations;
+  if (!bytes)
+    bytes = 1;
+  if (bytes > maxBlockSize)
+    {
+      ++mUpstreamAllocations;
+      return ::operator new(bytes);
+    }
+
+  const size_t sizeClass = classOf(bytes);
+  if (FreeBlock *block = mFreeLists[sizeClass])
+    {
+      mFreeLists[sizeClass] = block->next;
+      return block;
+    }
+
+  const size_t blockSize = (sizeClass + 1) * blockAlignment;
+  if (mChunkLeft < blockSize)
+    {
+      // the rest of the chunk is left unused, it is smaller than the block
+      ++mUpstreamAllocations;
+      mChunks.emplace_back(new char[chunkSize]);
+      mChunkPos = mChunks.back().get();
+      mChunkLeft = chunkSize;
+    }
+
+  void *block = mChunkPos;
+  mChunkPos += blockSize;
+  mChunkLeft -= blockSize;
+  return block;
+}
+
+void MemoryArena::deallocate(void *block, size_t bytes)
+{
+  if (!bytes)
+    bytes = 1;
+  if (bytes > maxBlockSize)
+    {
+      ::operator delete(block);
+      return;
+    }
+
+  FreeBlock *freeBlock = static_cast<FreeBlock*>(block);
+  const size_t sizeClass = classOf(bytes);
+  freeBlock->next = mFreeLists[sizeClass];
+  mFreeLists[sizeClass] = freeBlock;
+}
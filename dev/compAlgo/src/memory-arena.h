@@ -0,0 +1,73 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+
+//! @class MemoryArena serves the container allocations of one simulation from large chunks
+//! @brief freed blocks go to the free list of their size class and are reused,
+//!  all the chunks are released at once with the arena. Not thread-safe, one simulation runs on one thread.
+class MemoryArena
+{
+public:
+  MemoryArena() = default;
+
+  void* allocate(size_t bytes);
+  void deallocate(void *block, size_t bytes);
+
+  uint64_t allocationsCount() const { return mAllocations; }
+  uint64_t upstreamAllocationsCount() const { return mUpstreamAllocations; } //< chunks and oversized blocks
+
+private:
+  static constexpr size_t blockAlignment = alignof(std::max_align_t);
+  static constexpr size_t maxBlockSize = 1024;     //< larger blocks go to operator new
+  static constexpr size_t chunkSize = 64 * 1024;
+  static constexpr size_t classesCount = maxBlockSize / blockAlignment;
+
+  struct FreeBlock
+  {
+    FreeBlock *next;
+  };
+
+  std::array<FreeBlock*, classesCount> mFreeLists {{}};
+  std::vector<std::unique_ptr<char[]>> mChunks;
+  char *mChunkPos = nullptr;
+  size_t mChunkLeft = 0;
+
+  uint64_t mAllocations = 0;
+  uint64_t mUpstreamAllocations = 0;
+
+  MemoryArena(const MemoryArena &) = delete;
+  MemoryArena& operator =(const MemoryArena &) = delete;
+
+  static size_t classOf(size_t bytes) { return (bytes + blockAlignment - 1) / blockAlignment - 1; }
+};
+
+
+//! @class ArenaAllocator is the standard allocator interface of MemoryArena for the containers
+template <typename T>
+class ArenaAllocator
+{
+public:
+  using value_type = T;
+
+  //! @note implicit, so a container is constructed right from the arena
+  ArenaAllocator(MemoryArena &arena) : mArena(&arena) {}
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U> &other) : mArena(other.arena()) {}
+
+  T* allocate(size_t n) { return static_cast<T*>(mArena->allocate(n * sizeof(T))); }
+  void deallocate(T *block, size_t n) { mArena->deallocate(block, n * sizeof(T)); }
+
+  MemoryArena* arena() const { return mArena; }
+
+  template <typename U>
+  bool operator ==(const ArenaAllocator<U> &other) const { return mArena == other.arena(); }
+  template <typename U>
+  bool operator !=(const ArenaAllocator<U> &other) const { return mArena != other.arena(); }
+
+private:
+  MemoryArena *mArena;
+};
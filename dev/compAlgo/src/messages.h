@@ -5,9 +5,18 @@
 #include <deque>
 #include <map>
 #include <memory>
+#include <cstdint>
+#include <type_traits>
 
 using Time = uint64_t;
-using CsiUnit = std::pair<Time, int>; //< time of measurements received, rsrp
+
+//! @brief time of measurements received, rsrp
+//! @note plain struct instead of std::pair: it has to stay trivially copyable to live inside Event
+struct CsiUnit
+{
+  Time first;
+  int second;
+};
 using CsiArray = std::deque<CsiUnit>;
 
 using CellId = int;
@@ -19,7 +28,10 @@ using CsiJournalPtr = std::shared_ptr<CsiJournal>;
 
 struct DlRlcPacket
 {
-  std::string dlRlcStatLine;
+  uint64_t index;            //< of the line in DlRlcStats.txt after the header, see RlcLineTable
+  Time endTime;              //< end of the RLC stats interval
+  int rxBytes;
+  int imsi;
 };
 
 struct CSIMeasurementReport
@@ -30,22 +42,22 @@ struct CSIMeasurementReport
 
 struct X2Message
 {
-  enum X2MsgType
+  enum X2MsgType : uint8_t
   {
     measuresInd
     , changeScheduleModeInd
     , leadershipInd
   };
 
-  X2MsgType type;
   CSIMeasurementReport report;
-  bool mustSendTraffic;
   Time applyDirectMembership;
   CellId leaderCellId;
+  X2MsgType type;
+  bool mustSendTraffic;
 };
 
 
-enum class EventType
+enum class EventType : uint8_t
 {
   scheduleAttempt
   , csiIndicator
@@ -55,15 +67,20 @@ enum class EventType
 };
 
 
+//! @brief fixed-size header plus the payload of the concrete eventType
+//! @note only the union member matching eventType is valid
 struct Event
 {
-  EventType eventType;
   Time atTime;
   CellId cellId;
+  EventType eventType;
 
-  DlRlcPacket packet;
-  CSIMeasurementReport report;
-  X2Message message;
+  union
+  {
+    DlRlcPacket packet;             //< EventType::scheduleAttempt
+    CSIMeasurementReport report;    //< EventType::csiIndicator
+    X2Message message;              //< EventType::x2Message
+  };
 
   bool operator <(const Event &other) const
   {
@@ -75,9 +92,11 @@ struct Event
   }
 
   Event() {}
-  Event(EventType type, uint64_t time) : eventType(type), atTime(time) {}
+  Event(EventType type, uint64_t time) : atTime(time), eventType(type) {}
 };
 
+static_assert(std::is_trivially_copyable<Event>::value, "Event is copied on every event queue operation");
+
 
 
 
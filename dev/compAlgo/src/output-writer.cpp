@@ -0,0 +1,163 @@
+#include "output-writer.h"
+
+#include <assert.h>
+#include <zlib.h>
+
+#include "helpers.h"
+
+//! @class FileBuffer is one output file of OutputWriter
+class OutputWriter::FileBuffer : public std::streambuf
+{
+public:
+  FileBuffer(OutputWriter &owner, const std::string &location)
+    : mOwner(owner)
+    , mLocation(location)
+    , mFilled(bufferSize)
+    , mWriting(bufferSize)
+  {
+    if (SimConfig::compressOutputs)
+      {
+        mCompressedFile = gzopen((location + ".gz").c_str(), "wb");
+        assert(mCompressedFile);
+      }
+    else
+      {
+        mFile.open(location, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+        assert(mFile.is_open());
+      }
+    resetFilled();
+  }
+
+  ~FileBuffer()
+  {
+    mFile.flush();
+    if (mCompressedFile && gzclose(mCompressedFile) != Z_OK)
+      mIsCompressedBroken = true;
+    if (!mFile.good() || mIsCompressedBroken)
+      {
+        WARN("failed to write " << mLocation);
+      }
+  }
+
+  size_t filledSize() const { return pptr() - pbase(); }
+  void resetFilled() { setp(mFilled.data(), mFilled.data() + mFilled.size()); }
+
+  //! @brief the filled buffer becomes the one to write
+  void swapBuffers()
+  {
+    mWritingSize = filledSize();
+    mFilled.swap(mWriting);
+    resetFilled();
+  }
+  void writeSwapped()
+  {
+    if (mCompressedFile)
+      {
+        // the plain file keeps a failed write in its state, the compressed one is reported at the end as well
+        if (gzwrite(mCompressedFile, mWriting.data(), mWritingSize) != static_cast<int>(mWritingSize))
+          mIsCompressedBroken = true;
+      }
+    else
+      mFile.write(mWriting.data(), mWritingSize);
+  }
+
+  bool isPending = false; //< guarded by OutputWriter::mMutex
+
+protected:
+  int_type overflow(int_type ch) override
+  {
+    mOwner.handOff(*this);
+    if (!traits_type::eq_int_type(ch, traits_type::eof()))
+      {
+        *pptr() = traits_type::to_char_type(ch);
+        pbump(1);
+      }
+    return traits_type::not_eof(ch);
+  }
+
+  //! @note std::ostream::flush() hands the buffer to the writer, it does not wait for the disk
+  int sync() override
+  {
+    mOwner.handOff(*this);
+    return 0;
+  }
+
+private:
+  OutputWriter &mOwner;
+  const std::string mLocation;
+  std::ofstream mFile;
+  gzFile mCompressedFile = nullptr;
+  bool mIsCompressedBroken = false; //< a write or the close has failed
+  std::vector<char> mFilled;  //< by the simulation
+  std::vector<char> mWriting; //< by the writer thread while pending
+  size_t mWritingSize = 0;
+};
+
+
+OutputWriter::OutputWriter() = default;
+
+OutputWriter::~OutputWriter()
+{
+  for (auto &file : mFiles)
+    handOff(*file);
+
+  if (mWriter.joinable())
+    {
+      {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mFinished = true;
+      }
+      mHasPending.notify_one();
+      mWriter.join();
+    }
+}
+
+std::streambuf* OutputWriter::open(const std::string &location)
+{
+  if (!mWriter.joinable() && std::thread::hardware_concurrency() > 1)
+    mWriter = std::thread(&OutputWriter::work, this);
+
+  mFiles.emplace_back(new FileBuffer(*this, location));
+  return mFiles.back().get();
+}
+
+void OutputWriter::handOff(FileBuffer &file)
+{
+  if (!file.filledSize())
+    return;
+
+  if (!mWriter.joinable())
+    {
+      file.swapBuffers();
+      file.writeSwapped();
+      return;
+    }
+
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    mWritten.wait(lock, [&file] { return !file.isPending; });
+    file.swapBuffers();
+    file.isPending = true;
+    mPending.push_back(&file);
+  }
+  mHasPending.notify_one();
+}
+
+void OutputWriter::work()
+{
+  std::unique_lock<std::mutex> lock(mMutex);
+  while (true)
+    {
+      mHasPending.wait(lock, [this] { return mFinished || !mPending.empty(); });
+      if (mPending.empty())
+        return;
+
+      FileBuffer *file = mPending.front();
+      mPending.pop_front();
+      lock.unlock();
+      file->writeSwapped();
+      lock.lock();
+      file->isPending = false;
+      mWritten.notify_all();
+    }
+}
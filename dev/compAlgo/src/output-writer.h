@@ -0,0 +1,71 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+//! @class OutputWriter writes the output files of a simulation on a background writer thread
+//! @brief every file is a streambuf with two buffers: the simulation fills one while the writer
+//!  thread puts the other one to the disk with one large write. The simulation waits only if
+//!  it fills a buffer before the previous one is written. On a single core the buffers are
+//!  written right away, the thread would only compete with the simulation.
+//!  With SimConfig::compressOutputs the files are deflated by the writer thread as well.
+class OutputWriter
+{
+public:
+  static constexpr size_t bufferSize = 1 << 20;
+
+  OutputWriter();
+  //! @brief writes what is left in the buffers and closes the files
+  ~OutputWriter();
+
+  //! @brief truncates the file, "<location>.gz" if the outputs are compressed
+  //! @return buffer of the file for std::ostream, valid while the writer lives
+  std::streambuf* open(const std::string &location);
+
+private:
+  class FileBuffer;
+
+  std::vector<std::unique_ptr<FileBuffer>> mFiles;
+  std::deque<FileBuffer*> mPending;  //< files with a filled buffer to write, in order
+  std::mutex mMutex;
+  std::condition_variable mHasPending;
+  std::condition_variable mWritten;
+  bool mFinished = false;
+  std::thread mWriter;               //< started with the first file
+
+  OutputWriter(const OutputWriter &) = delete;
+  OutputWriter& operator =(const OutputWriter &) = delete;
+
+  void handOff(FileBuffer &file);
+  void work();
+};
+
+
+//! @class FileLogger writes the values of interest to their own file, one per line
+class FileLogger
+{
+public:
+  //! @arg location empty to drop all the writes
+  FileLogger(const std::string &location, OutputWriter &writer) : mLocation(location), mWriter(writer) {}
+
+  template <typename T>
+  void write(T &stream)
+  {
+    if (mLocation.empty())
+      return;
+    if (!mStream.rdbuf())
+      mStream.rdbuf(mWriter.open(mLocation));
+    mStream << stream << "\n";
+  }
+
+private:
+  const std::string mLocation;
+  OutputWriter &mWriter;
+  std::ostream mStream {nullptr};
+};
@@ -0,0 +1,91 @@
+#include "packet-selection.h"
+
+#include <fstream>
+
+#include "checkpoint.h"
+
+namespace
+{
+  const char *const selectionSignature = "compAlgo packet selection";
+  const uint32_t selectionVersion = 1;
+  const size_t wordBits = 64;
+}
+
+void PacketSelection::select(uint64_t index)
+{
+  if (index / wordBits >= mWords.size())
+    mWords.resize(index / wordBits + 1);
+  mWords[index / wordBits] |= uint64_t(1) << (index % wordBits);
+}
+
+bool PacketSelection::isSelected(uint64_t index) const
+{
+  return index / wordBits < mWords.size() && (mWords[index / wordBits] >> (index % wordBits) & 1);
+}
+
+void PacketSelection::merge(const PacketSelection &other)
+{
+  if (other.mWords.size() > mWords.size())
+    mWords.resize(other.mWords.size());
+  for (size_t i = 0; i < other.mWords.size(); ++i)
+    mWords[i] |= other.mWords[i];
+}
+
+bool PacketSelection::save(const std::string &location) const
+{
+  std::fstream file(location, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+  if (!file.is_open())
+    return false;
+
+  CheckpointWriter writer(file);
+  writer.write(std::string(selectionSignature));
+  writer.write(selectionVersion);
+  writer.write(mWords);
+  file.flush();
+  return writer.good();
+}
+
+bool PacketSelection::load(const std::string &location)
+{
+  std::fstream file(location, std::ios_base::in | std::ios_base::binary);
+  if (!file.is_open())
+    return false;
+
+  CheckpointReader reader(file);
+  std::string signature;
+  uint32_t version = 0;
+  reader.read(signature);
+  reader.read(version);
+  if (!reader.good() || signature != selectionSignature || version != selectionVersion)
+    return false;
+  reader.read(mWords);
+  return reader.good();
+}
+
+void PacketSelection::materialize(const RlcLineTable &lines, std::ostream &stream) const
+{
+  stream << RlcLineTable::header;
+  writeLines(lines, stream);
+}
+
+void PacketSelection::writeLines(const RlcLineTable &lines, std::ostream &stream) const
+{
+  if (lines.isCompressed())
+    {
+      lines.forEachLine([this, &stream] (uint64_t index, const char *begin, const char *end)
+      {
+        if (isSelected(index))
+          {
+            stream.write(begin, end - begin);
+            stream << "\n";
+          }
+      });
+      return;
+    }
+
+  for (size_t i = 0; i < mWords.size(); ++i)
+    {
+      for (uint64_t word = mWords[i]; word; word &= word - 1)
+        lines.write(stream, i * wordBits + __builtin_ctzll(word));
+    }
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <iostream>
+
+#include "rlc-line-table.h"
+
+//! @class PacketSelection marks the transmitted packets by DlRlcPacket::index, one bit each
+//! @brief the compact RLC output of SimConfig::rlcSelectionOutput, saved as "DlRlcStats.sel".
+//!  The text of the selected lines is made on demand by materialize() or the rlc-select tool.
+class PacketSelection
+{
+public:
+  void select(uint64_t index);
+  bool isSelected(uint64_t index) const;
+  //! @brief adds the packets selected by the other one
+  void merge(const PacketSelection &other);
+
+  //! @return false if the file cannot be written
+  bool save(const std::string &location) const;
+  //! @return false if there is no selection file of this version
+  bool load(const std::string &location);
+
+  //! @brief writes DlRlcStats.txt as the text output mode does
+  void materialize(const RlcLineTable &lines, std::ostream &stream) const;
+  //! @brief writes the selected lines in the order of the trace, without the header
+  void writeLines(const RlcLineTable &lines, std::ostream &stream) const;
+
+private:
+  std::vector<uint64_t> mWords;
+};
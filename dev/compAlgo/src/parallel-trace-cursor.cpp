@@ -0,0 +1,126 @@
+#include "parallel-trace-cursor.h"
+
+#include <cstring>
+#include <atomic>
+#include <thread>
+#include <algorithm>
+
+constexpr size_t ParallelTraceCursor::minChunkSize;
+constexpr size_t ParallelTraceCursor::chunksPerThread;
+
+ParallelTraceCursor::ParallelTraceCursor(const std::string &location, TraceKind kind, size_t threadsCount, Time from)
+  : mKind(kind)
+  , mTrace(location)
+{
+  assert(mTrace.isOpen());
+  threadsCount = std::max<size_t>(threadsCount, 1);
+  split(std::min(threadsCount * chunksPerThread, mTrace.size() / minChunkSize + 1));
+  threadsCount = std::min(threadsCount, mChunks.size());
+  LOG("parsing " << location << " in " << mChunks.size() << " chunks on " << threadsCount << " threads");
+
+  // chunks are taken in order, their results do not depend on the worker
+  std::atomic<size_t> nextChunk(0);
+  auto work = [&]()
+  {
+    for (size_t i = nextChunk++; i < mChunks.size(); i = nextChunk++)
+      parse(mChunks[i]);
+  };
+  std::vector<std::thread> workers;
+  for (size_t i = 1; i < threadsCount; ++i)
+    workers.emplace_back(work);
+  work();
+  for (auto &worker : workers)
+    worker.join();
+
+  uint64_t firstLineNumber = 0;
+  for (Chunk &chunk : mChunks)
+    {
+      for (const auto &line : chunk.brokenLines)
+        {
+          if (kind == TraceKind::rlcStats)
+            RlcTraceCursor::warnBroken(line.first, line.second);
+          else
+            MeasurementsTraceCursor::warnBroken(line.first, line.second);
+        }
+      if (kind == TraceKind::rlcStats)
+        for (Event &event : chunk.events)
+          event.packet.index += firstLineNumber;
+      firstLineNumber += chunk.linesCount;
+    }
+
+  while (!empty() && front().atTime < from)
+    pop();
+}
+
+bool ParallelTraceCursor::empty()
+{
+  while (mChunk < mChunks.size() && mPosition == mChunks[mChunk].events.size())
+    {
+      ++mChunk;
+      mPosition = 0;
+    }
+  return mChunk == mChunks.size();
+}
+
+const Event &ParallelTraceCursor::front()
+{
+  assert(!empty());
+  return mChunks[mChunk].events[mPosition];
+}
+
+void ParallelTraceCursor::pop()
+{
+  assert(!empty());
+  ++mPosition;
+}
+
+void ParallelTraceCursor::split(size_t chunksCount)
+{
+  const char *data = mTrace.data();
+  const char *end = data + mTrace.size();
+  // first line dummy
+  const char *headerEnd = static_cast<const char*>(memchr(data, '\n', mTrace.size()));
+  const char *begin = headerEnd ? headerEnd + 1 : end;
+
+  const size_t chunkSize = (end - begin) / chunksCount + 1;
+  while (begin < end)
+    {
+      const char *chunkEnd = begin + std::min<size_t>(chunkSize, end - begin);
+      // the chunk ends after a line break, the last one may end without it
+      const char *lineEnd = static_cast<const char*>(memchr(chunkEnd - 1, '\n', end - chunkEnd + 1));
+      chunkEnd = lineEnd ? lineEnd + 1 : end;
+
+      Chunk chunk;
+      chunk.begin = begin;
+      chunk.end = chunkEnd;
+      mChunks.push_back(std::move(chunk));
+      begin = chunkEnd;
+    }
+}
+
+void ParallelTraceCursor::parse(Chunk &chunk) const
+{
+  if (mKind == TraceKind::rlcStats)
+    parseLines<RlcTraceCursor>(chunk);
+  else
+    parseLines<MeasurementsTraceCursor>(chunk);
+}
+
+template <typename Parser>
+void ParallelTraceCursor::parseLines(Chunk &chunk)
+{
+  for (const char *begin = chunk.begin; begin < chunk.end; ++chunk.linesCount)
+    {
+      const char *end = static_cast<const char*>(memchr(begin, '\n', chunk.end - begin));
+      if (!end)
+        end = chunk.end;
+
+      typename Parser::Record record;
+      const LineParse result = Parser::parse(begin, end, record);
+      if (result == LineParse::broken)
+        chunk.brokenLines.emplace_back(begin, end);
+      else if (result == LineParse::event)
+        chunk.events.push_back(eventOf(record, chunk.linesCount));
+      begin = end + 1;
+    }
+}
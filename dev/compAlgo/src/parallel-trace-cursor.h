@@ -0,0 +1,47 @@
+#pragma once
+
+#include <vector>
+
+#include "trace-cursor.h"
+#include "mapped-file.h"
+
+//! @class ParallelTraceCursor parses a whole text trace at once on several threads
+//! @brief the file is split into chunks at line breaks, every chunk is parsed by a worker into its own buffers
+//!  and the chunks are read in the file order, so the events and the warnings are the same as of TraceFileCursor
+class ParallelTraceCursor : public ITraceCursor
+{
+public:
+  //! @arg from time of the first event, earlier ones are skipped
+  ParallelTraceCursor(const std::string &location, TraceKind kind, size_t threadsCount, Time from = 0);
+
+  bool empty() override;
+  const Event& front() override;
+  void pop() override;
+
+private:
+  static constexpr size_t minChunkSize = 1 << 20;
+  static constexpr size_t chunksPerThread = 4; //< the workers finish at about the same time
+
+  struct Chunk
+  {
+    const char *begin;
+    const char *end;
+    std::vector<Event> events; //< DlRlcPacket::index is counted from the chunk begin till all are parsed
+    uint64_t linesCount = 0;
+    std::vector<std::pair<const char*, const char*>> brokenLines; //< warned after the parsing
+  };
+
+  const TraceKind mKind;
+  MappedFile mTrace;
+  std::vector<Chunk> mChunks;
+  size_t mChunk = 0;    //< of the front event
+  size_t mPosition = 0; //< of the front event in its chunk
+
+  ParallelTraceCursor(const ParallelTraceCursor &) = delete;
+  ParallelTraceCursor& operator =(const ParallelTraceCursor &) = delete;
+
+  void split(size_t chunksCount);
+  void parse(Chunk &chunk) const;
+  template <typename Parser>
+  static void parseLines(Chunk &chunk);
+};
@@ -0,0 +1,516 @@
+#include "partitioned-simulator.h"
+
+#include <thread>
+#include <limits>
+#include <algorithm>
+
+#include "sim-context.h"
+
+namespace
+{
+  const uint64_t activationRank = 0;
+  const uint64_t dynamicRank = std::numeric_limits<uint64_t>::max();
+
+  uint64_t traceRank(size_t index)
+  {
+    return index + 1;
+  }
+}
+
+
+//! @class KeyedLineBuffer keeps the output lines of a logical process along with their order keys
+class PartitionedSimulator::KeyedLineBuffer : public std::streambuf
+{
+public:
+  struct Line
+  {
+    OrderKey key;
+    size_t end; //< the line begins at the end of the previous one
+  };
+
+  KeyedLineBuffer(const OrderKey &key) : mKey(key) {}
+
+  const std::string& data() const { return mData; }
+  const std::vector<Line>& lines() const { return mLines; }
+
+  size_t lineBegin(size_t line) const { return line ? mLines[line - 1].end : 0; }
+  void clear()
+  {
+    mData.erase(0, lineBegin(mLines.size()));
+    mLines.clear();
+  }
+
+protected:
+  int_type overflow(int_type ch) override
+  {
+    if (!traits_type::eq_int_type(ch, traits_type::eof()))
+      append(traits_type::to_char_type(ch));
+    return traits_type::not_eof(ch);
+  }
+
+  std::streamsize xsputn(const char *s, std::streamsize n) override
+  {
+    for (std::streamsize i = 0; i < n; i++)
+      append(s[i]);
+    return n;
+  }
+
+private:
+  const OrderKey &mKey;
+  std::string mData;
+  std::vector<Line> mLines;
+
+  void append(char ch)
+  {
+    mData.push_back(ch);
+    if (ch == '\n')
+      mLines.push_back({mKey, mData.size()});
+  }
+};
+
+
+//! @class LogicalProcess runs the events of one cell within a time window
+class PartitionedSimulator::LogicalProcess
+{
+public:
+  LogicalProcess(CellId cellId, PartitionedSimulator &owner, const std::string &outputDir,
+                 const AlgoConfig &algoConfig);
+
+  void addTraceEvent(size_t index) { mTraceEvents.push_back(index); }
+  void activate();
+
+  Time nextEventTime();
+  //! @brief processes all the events before windowEnd
+  void runWindow(Time windowEnd);
+  void deliver(const Event &event) { mContext.eventQueue().push(event); }
+
+  L2Mac& mac() { return *mMac; }
+  const X2Channel& x2Channel() { return mContext.x2Channel(); }
+  Time lookahead() const { return mLookahead; }
+
+  std::vector<Event> outbox;        //< events of the next windows, they go through the coordinator
+  std::vector<OrderKey> outboxKeys; //< when each event was scheduled
+  std::map<std::string, std::unique_ptr<KeyedLineBuffer>> outputs;
+  std::vector<char> subframeDecisions; //< of this cell at the frame-miss checks
+  uint64_t processedEvents = 0;
+
+private:
+  PartitionedSimulator &mOwner;
+  const CellId mCellId;
+  SimContext mContext;
+  std::unique_ptr<L2Mac> mMac;
+  Time mLookahead;
+
+  std::vector<size_t> mTraceEvents; //< indices in the owner's TraceBuffer
+  size_t mNextTraceEvent = 0;
+  size_t mNextSubframe = 0;
+  OrderKey mOutputKey {0, activationRank};
+
+  std::vector<Event> mAttempt;
+  std::vector<Event> mTickEvents;
+  std::vector<uint64_t> mTickRanks;
+
+  LogicalProcess(const LogicalProcess &) = delete;
+  LogicalProcess& operator =(const LogicalProcess &) = delete;
+
+  void sampleSubframes(Time until);
+  void dispatch(const Event &event, const OrderKey &key);
+};
+
+PartitionedSimulator::LogicalProcess::LogicalProcess(CellId cellId, PartitionedSimulator &owner,
+                                                     const std::string &outputDir, const AlgoConfig &algoConfig)
+  : mOwner(owner)
+  , mCellId(cellId)
+  , mContext("", outputDir, algoConfig)
+  , mAttempt(1)
+{
+  mContext.routeOutputs([this] (const std::string &file)
+  {
+    std::unique_ptr<KeyedLineBuffer> &buffer = outputs[file];
+    buffer.reset(new KeyedLineBuffer(mOutputKey));
+    return buffer.get();
+  });
+  mContext.setRlcLines(owner.mTraces->rlcLines());
+  mMac.reset(new L2Mac(mContext, cellId));
+  // the messages of all the cells to one target are shifted apart by the coordinator
+  mContext.x2Channel().deferTieBreak();
+  mLookahead = mContext.x2Channel().minimalLatency();
+}
+
+void PartitionedSimulator::LogicalProcess::activate()
+{
+  subframeDecisions.assign(mOwner.mSubframes.size(), false);
+
+  mContext.setHorizon(Converter::milliseconds(0), &outbox);
+  mContext.setTime(Converter::milliseconds(0));
+  mOutputKey = {mContext.getTime(), activationRank};
+  mMac->activateDlCompFeature();
+  outboxKeys.resize(outbox.size(), mOutputKey);
+}
+
+Time PartitionedSimulator::LogicalProcess::nextEventTime()
+{
+  Time time = std::numeric_limits<Time>::max();
+  if (mNextTraceEvent < mTraceEvents.size())
+    time = (*mOwner.mTraces)[mTraceEvents[mNextTraceEvent]].atTime;
+  if (!mContext.eventQueue().empty())
+    time = std::min(time, mContext.eventQueue().nextTime());
+  return time;
+}
+
+void PartitionedSimulator::LogicalProcess::runWindow(Time windowEnd)
+{
+  const TraceBuffer &traces = *mOwner.mTraces;
+  IEventQueue &eventQueue = mContext.eventQueue();
+  mContext.setHorizon(windowEnd, &outbox);
+
+  while (true)
+    {
+      const Time time = nextEventTime();
+      if (time >= windowEnd)
+        break;
+      // the check at the subframe start goes before its events
+      sampleSubframes(time + 1);
+      mContext.setTime(time);
+
+      // schedule attempts first, then trace events, then scheduled ones, see Simulator::run
+      mTickEvents.clear();
+      mTickRanks.clear();
+      for (; mNextTraceEvent < mTraceEvents.size() && traces[mTraceEvents[mNextTraceEvent]].atTime == time;
+           ++mNextTraceEvent)
+        {
+          const size_t index = mTraceEvents[mNextTraceEvent];
+          if (traces[index].eventType != EventType::scheduleAttempt)
+            {
+              mTickEvents.push_back(traces[index]);
+              mTickRanks.push_back(traceRank(index));
+              continue;
+            }
+          // one by one to key every output line, decisions are the same as for the whole batch
+          mOutputKey = {time, traceRank(index)};
+          mAttempt.front() = traces[index];
+          mMac->makeScheduleDecisions(mAttempt);
+          outboxKeys.resize(outbox.size(), mOutputKey);
+          ++processedEvents;
+        }
+      while (!eventQueue.empty() && eventQueue.nextTime() == time)
+        {
+          mTickEvents.push_back(eventQueue.pop());
+          mTickRanks.push_back(dynamicRank);
+        }
+
+      for (size_t i = 0; i < mTickEvents.size(); i++)
+        dispatch(mTickEvents[i], {time, mTickRanks[i]});
+      processedEvents += mTickEvents.size();
+    }
+  sampleSubframes(windowEnd);
+}
+
+void PartitionedSimulator::LogicalProcess::sampleSubframes(Time until)
+{
+  const std::vector<Time> &subframes = mOwner.mSubframes;
+  for (; mNextSubframe < subframes.size() && subframes[mNextSubframe] < until; ++mNextSubframe)
+    {
+      mContext.setTime(subframes[mNextSubframe]);
+      subframeDecisions[mNextSubframe] = mMac->peekDirectDecision(mCellId);
+    }
+}
+
+void PartitionedSimulator::LogicalProcess::dispatch(const Event &event, const OrderKey &key)
+{
+  mOutputKey = key;
+  mMac->dispatch(event);
+  outboxKeys.resize(outbox.size(), key);
+}
+
+
+PartitionedSimulator::PartitionedSimulator(TraceBufferPtr traces, const std::string &outputDir,
+                                           size_t threadsCount, const AlgoConfig &algoConfig)
+  : mTraces(traces)
+  , mOutputDir(outputDir)
+  , mThreadsCount(threadsCount)
+{
+  const TraceBuffer &buffer = *mTraces;
+  for (size_t i = 0; i < buffer.size(); i++)
+    {
+      const Event &event = buffer[i];
+      if (event.eventType == EventType::scheduleAttempt && event.atTime > Converter::milliseconds(0)
+          && (mSubframes.empty() || mSubframes.back() != event.atTime))
+        mSubframes.push_back(event.atTime);
+    }
+  mStopTime = (buffer.size()? buffer[buffer.size() - 1].atTime : 0) + Converter::milliseconds(100);
+
+  mProcesses.emplace_back(new LogicalProcess(1, *this, outputDir, algoConfig));
+  const int cellsCount = mProcesses.front()->mac().cellsCount();
+  for (CellId cellId = 2; cellId <= cellsCount; cellId++)
+    mProcesses.emplace_back(new LogicalProcess(cellId, *this, outputDir, algoConfig));
+  mLookahead = mProcesses.front()->lookahead();
+
+  for (size_t i = 0; i < buffer.size(); i++)
+    {
+      const CellId cellId = buffer[i].cellId;
+      assert(cellId >= 1 && cellId <= cellsCount);
+      mProcesses[cellId - 1]->addTraceEvent(i);
+    }
+
+  // every process has written the same headers
+  for (auto &output : mProcesses.front()->outputs)
+    {
+      std::unique_ptr<std::ostream> &file = mOutputFiles[output.first];
+      file.reset(new std::ostream(mOutputWriter.open(mOutputDir + "/" + output.first)));
+      *file << output.second->data();
+    }
+  for (auto &process : mProcesses)
+    {
+      for (auto &output : process->outputs)
+        output.second->clear();
+    }
+
+  if (!mThreadsCount)
+    mThreadsCount = std::max(std::thread::hardware_concurrency(), 1u);
+  mThreadsCount = std::min(mThreadsCount, mProcesses.size());
+}
+
+PartitionedSimulator::~PartitionedSimulator()
+{
+  uint64_t processedEvents = 0;
+  for (const auto &process : mProcesses)
+    processedEvents += process->processedEvents;
+  // wall time, as the Simulator has it, so that the speed-up of the threads shows
+  const double runTime = mTimeMeasurement.average("run") / 1000 / 1000;
+  LOG("Simulation time: " << runTime << " [s]\t(" << mProcesses.size() << " cells on "
+      << mThreadsCount << " threads)");
+  LOG("Processed events: " << processedEvents << "\t(" << processedEvents / runTime << " [events/s])");
+  LOG("Not used timeframes: " << mMissedFrameCounter << "\t(about " << mMissedFrameCounter / 1000.0 << " [s])\n");
+  logThroughput(statistics());
+}
+
+void PartitionedSimulator::run()
+{
+  const std::string fname = "run";
+  LOG("\n\tPartitioned simulation has been started...\n");
+  mTimeMeasurement.start(fname);
+
+  for (auto &process : mProcesses)
+    process->activate();
+  deliverMessages();
+
+  std::vector<std::thread> workers;
+  for (size_t i = 1; i < mThreadsCount; i++)
+    workers.emplace_back(&PartitionedSimulator::work, this, i);
+
+  while (true)
+    {
+      Time windowStart = mStopTime;
+      for (auto &process : mProcesses)
+        windowStart = std::min(windowStart, process->nextEventTime());
+      if (windowStart >= mStopTime)
+        break;
+
+      const Time windowEnd = std::min(windowStart + mLookahead, mStopTime);
+      runWindow(windowEnd);
+
+      checkSubframes(windowEnd);
+      deliverMessages();
+      mergeOutputs();
+    }
+
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mFinished = true;
+  }
+  mWindowStarted.notify_all();
+  for (auto &worker : workers)
+    worker.join();
+
+  const RlcLinesPtr &rlcLines = mTraces->rlcLines();
+  if (SimConfig::rlcOutputMode != SimConfig::rlcTextOutput || (rlcLines && rlcLines->isCompressed()))
+    collectTransmitted();
+  for (auto &file : mOutputFiles)
+    file.second->flush();
+  LOG("Stop event was reached");
+  mTimeMeasurement.stop(fname);
+}
+
+void PartitionedSimulator::collectTransmitted()
+{
+  PacketSelection transmitted;
+  for (const UniqLogicalProcess &process : mProcesses)
+    transmitted.merge(process->mac().transmitted());
+
+  // the trace buffer is in the order of the merged lines of the text output
+  const TraceBuffer &traces = *mTraces;
+  for (size_t i = 0; i < traces.size(); i++)
+    if (traces[i].eventType == EventType::scheduleAttempt && transmitted.isSelected(traces[i].packet.index))
+      mThroughput.add(traces[i].atTime, traces[i].packet);
+
+  auto rlcStats = mOutputFiles.find("DlRlcStats.txt");
+  if (SimConfig::rlcOutputMode == SimConfig::rlcTextOutput && rlcStats != mOutputFiles.end())
+    transmitted.writeLines(*mTraces->rlcLines(), *rlcStats->second);
+  if (SimConfig::rlcOutputMode == SimConfig::rlcSelectionOutput && !mOutputDir.empty()
+      && !transmitted.save(mOutputDir + "/DlRlcStats.sel"))
+    {
+      WARN("failed to write " << mOutputDir << "/DlRlcStats.sel");
+    }
+}
+
+MacStatistics PartitionedSimulator::statistics() const
+{
+  MacStatistics result;
+  result.aveThroughputKbps = mThroughput.averageKbps();
+  result.maxThroughputKbps = mThroughput.maximumKbps();
+  result.ueThroughputs = mThroughput.ueThroughputs();
+  for (const UniqLogicalProcess &process : mProcesses)
+    result.cellSwitches += process->mac().statistics().cellSwitches;
+  result.missedFrames = mMissedFrameCounter;
+  return result;
+}
+
+void PartitionedSimulator::work(size_t worker)
+{
+  uint64_t generation = 0;
+  while (true)
+    {
+      {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mWindowStarted.wait(lock, [&] { return mFinished || mWindowGeneration != generation; });
+        if (mFinished)
+          return;
+        generation = mWindowGeneration;
+      }
+
+      runShare(worker);
+
+      std::lock_guard<std::mutex> lock(mMutex);
+      if (--mBusyWorkers == 0)
+        mWindowDone.notify_one();
+    }
+}
+
+void PartitionedSimulator::runShare(size_t worker)
+{
+  for (size_t i = worker; i < mProcesses.size(); i += mThreadsCount)
+    mProcesses[i]->runWindow(mWindowEnd);
+}
+
+void PartitionedSimulator::runWindow(Time windowEnd)
+{
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mWindowEnd = windowEnd;
+    mBusyWorkers = mThreadsCount - 1;
+    ++mWindowGeneration;
+  }
+  mWindowStarted.notify_all();
+
+  runShare(0);
+
+  std::unique_lock<std::mutex> lock(mMutex);
+  mWindowDone.wait(lock, [&] { return mBusyWorkers == 0; });
+}
+
+void PartitionedSimulator::checkSubframes(Time until)
+{
+  for (; mCheckedSubframes < mSubframes.size() && mSubframes[mCheckedSubframes] < until; ++mCheckedSubframes)
+    {
+      int directCells = 0;
+      for (auto &process : mProcesses)
+        directCells += process->subframeDecisions[mCheckedSubframes];
+
+      if (directCells > 1)
+        {
+          ERR("@" << mSubframes[mCheckedSubframes] << "\tASSERT:\tDual transmission");
+        }
+      if (!directCells)
+        {
+          mMissedFrameCounter += 1;
+          LOG(">" << (mCheckedSubframes ? mSubframes[mCheckedSubframes - 1] : 0) << "  frame miss");
+        }
+    }
+}
+
+void PartitionedSimulator::deliverMessages()
+{
+  struct Scheduled
+  {
+    OrderKey key;
+    size_t process;
+    const Event *event;
+  };
+
+  std::vector<Scheduled> scheduled;
+  for (size_t i = 0; i < mProcesses.size(); i++)
+    {
+      LogicalProcess &process = *mProcesses[i];
+      for (size_t k = 0; k < process.outbox.size(); k++)
+        scheduled.push_back({process.outboxKeys[k], i, &process.outbox[k]});
+    }
+  // equal time events are queued in the order they were scheduled
+  std::stable_sort(scheduled.begin(), scheduled.end(), [] (const Scheduled &l, const Scheduled &r)
+  {
+    return l.key < r.key;
+  });
+
+  const X2Channel &x2Channel = mProcesses.front()->x2Channel();
+  for (const Scheduled &item : scheduled)
+    {
+      Event event = *item.event;
+      // the equal arrivals are shifted apart in the order the sequential run sends the messages,
+      // the shifted ones stay past the window
+      if (event.eventType == EventType::x2Message)
+        event.atTime = X2Channel::tieBreak(mLastX2Arrivals, x2Channel.targetOf(event, item.key.time), event.atTime);
+
+      const CellId cellId = event.cellId;
+      const bool isCellEvent = cellId >= 1 && cellId <= static_cast<CellId>(mProcesses.size());
+      mProcesses[isCellEvent ? cellId - 1 : item.process]->deliver(event);
+    }
+
+  for (auto &process : mProcesses)
+    {
+      process->outbox.clear();
+      process->outboxKeys.clear();
+    }
+}
+
+void PartitionedSimulator::mergeOutputs()
+{
+  for (auto &file : mOutputFiles)
+    {
+      mMergedLines.clear();
+      for (auto &process : mProcesses)
+        {
+          auto output = process->outputs.find(file.first);
+          if (output == process->outputs.end())
+            continue;
+          KeyedLineBuffer *buffer = output->second.get();
+          for (size_t i = 0; i < buffer->lines().size(); i++)
+            mMergedLines.push_back({buffer->lines()[i].key, buffer, i});
+        }
+      std::stable_sort(mMergedLines.begin(), mMergedLines.end(), [] (const KeyedLine &l, const KeyedLine &r)
+      {
+        return l.key < r.key;
+      });
+
+      // transmitted attempts are the lines of DlRlcStats.txt
+      const bool isRlcStats = file.first == "DlRlcStats.txt";
+      for (const KeyedLine &line : mMergedLines)
+        {
+          const KeyedLineBuffer &buffer = *line.buffer;
+          const size_t begin = buffer.lineBegin(line.line);
+          file.second->write(buffer.data().data() + begin, buffer.lines()[line.line].end - begin);
+
+          if (isRlcStats)
+            {
+              const Event &attempt = (*mTraces)[line.key.rank - traceRank(0)];
+              mThroughput.add(attempt.atTime, attempt.packet);
+            }
+        }
+
+      for (auto &process : mProcesses)
+        {
+          auto output = process->outputs.find(file.first);
+          if (output != process->outputs.end())
+            output->second->clear();
+        }
+    }
+}
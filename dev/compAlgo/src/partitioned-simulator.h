@@ -0,0 +1,98 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <condition_variable>
+
+#include "helpers.h"
+#include "trace-buffer.h"
+#include "output-writer.h"
+#include "lteEnb/l2-mac.h"
+
+//! @class PartitionedSimulator is a conservative parallel simulation with one logical process per cell
+//! @brief Cells interact only through X2Channel and every message arrives X2Channel::minimalLatency()
+//!  after it is sent or later. So the processes run in parallel through time windows of that width,
+//!  then the coordinator delivers the messages sent within the window and merges the output files.
+//!  Events, outputs and frame-miss checks come in the same order as the sequential Simulator has.
+//!  The X2 messages of all the cells to one target arriving at the same time are shifted apart
+//!  by the coordinator, as the one X2Channel of the sequential run does.
+class PartitionedSimulator
+{
+public:
+  //! @arg threadsCount 0 to take all the hardware threads
+  PartitionedSimulator(TraceBufferPtr traces, const std::string &outputDir, size_t threadsCount = 0,
+                       const AlgoConfig &algoConfig = AlgoConfig());
+  ~PartitionedSimulator();
+
+  void run();
+  MacStatistics statistics() const;
+
+private:
+  //! @brief order of the sequential Simulator on equal time:
+  //!  the activation, trace events by index, then the scheduled events
+  struct OrderKey
+  {
+    Time time;
+    uint64_t rank;
+
+    bool operator <(const OrderKey &other) const
+    {
+      return time < other.time || (time == other.time && rank < other.rank);
+    }
+  };
+
+  class KeyedLineBuffer;
+  class LogicalProcess;
+  using UniqLogicalProcess = std::unique_ptr<LogicalProcess>;
+
+  struct KeyedLine
+  {
+    OrderKey key;
+    KeyedLineBuffer *buffer;
+    size_t line;
+  };
+
+  TraceBufferPtr mTraces;
+  std::vector<UniqLogicalProcess> mProcesses;
+  std::vector<Time> mSubframes;     //< times of the frame-miss checks, see L2Mac::makeScheduleDecisions
+  size_t mCheckedSubframes = 0;
+  Time mStopTime = Converter::milliseconds(0);
+  Time mLookahead = Converter::milliseconds(0);
+  std::map<int, Time> mLastX2Arrivals; //< by the target of X2Channel::send, across the windows
+
+  const std::string mOutputDir;
+  OutputWriter mOutputWriter;
+  std::map<std::string, std::unique_ptr<std::ostream>> mOutputFiles;
+  std::vector<KeyedLine> mMergedLines;
+  ThroughputMeter mThroughput;
+  size_t mMissedFrameCounter = 0;
+  TimeMeasurement mTimeMeasurement;
+
+  //- Worker threads ----------------------------------------
+  size_t mThreadsCount;
+  std::mutex mMutex;
+  std::condition_variable mWindowStarted;
+  std::condition_variable mWindowDone;
+  uint64_t mWindowGeneration = 0;
+  size_t mBusyWorkers = 0;
+  bool mFinished = false;
+  Time mWindowEnd = Converter::milliseconds(0);
+  //----------------------------------------------------------
+
+  PartitionedSimulator(const PartitionedSimulator &) = delete;
+  PartitionedSimulator& operator =(const PartitionedSimulator &) = delete;
+
+  void work(size_t worker);
+  void runShare(size_t worker);
+  void runWindow(Time windowEnd);
+
+  void checkSubframes(Time until);
+  void deliverMessages();
+  void mergeOutputs();
+  //! @brief without the text RLC output the throughput is taken from the transmitted packets,
+  //!  they are saved in SimConfig::rlcSelectionOutput mode. The text output of a compressed RLC trace
+  //!  is written from them as well.
+  void collectTransmitted();
+};
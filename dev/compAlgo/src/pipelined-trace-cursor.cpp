@@ -0,0 +1,73 @@
+#include "pipelined-trace-cursor.h"
+
+PipelinedTraceCursor::PipelinedTraceCursor(UniqTraceCursor source, size_t capacity)
+  : mSource(std::move(source))
+  , mRing(capacity)
+{
+  mParser = std::thread(&PipelinedTraceCursor::parse, this);
+}
+
+PipelinedTraceCursor::~PipelinedTraceCursor()
+{
+  mCancelled.store(true);
+  mParser.join();
+}
+
+bool PipelinedTraceCursor::empty()
+{
+  return !waitFront();
+}
+
+const Event &PipelinedTraceCursor::front()
+{
+  const bool hasFront = waitFront();
+  assert(hasFront);
+  UNUSED(hasFront);
+  return *mFront;
+}
+
+void PipelinedTraceCursor::pop()
+{
+  assert(mFront);
+  mRing.consume();
+  mFront = nullptr;
+}
+
+bool PipelinedTraceCursor::waitFront()
+{
+  while (!mFront)
+    {
+      mFront = mRing.consumerSlot();
+      if (mFront)
+        break;
+
+      if (mSourceIsOver.load(std::memory_order_acquire))
+        {
+          // the last events could be published right before the flag
+          mFront = mRing.consumerSlot();
+          return mFront != nullptr;
+        }
+      std::this_thread::yield();
+    }
+  return true;
+}
+
+void PipelinedTraceCursor::parse()
+{
+  while (!mSource->empty())
+    {
+      Event *slot = nullptr;
+      while (!(slot = mRing.producerSlot()))
+        {
+          if (mCancelled.load(std::memory_order_relaxed))
+            return;
+          std::this_thread::yield();
+        }
+
+      *slot = mSource->front();
+      mRing.publish();
+      mSource->pop();
+    }
+
+  mSourceIsOver.store(true, std::memory_order_release);
+}
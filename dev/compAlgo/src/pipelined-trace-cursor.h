@@ -0,0 +1,34 @@
+#pragma once
+
+#include <thread>
+
+#include "trace-cursor.h"
+#include "spsc-ring.h"
+
+//! @class PipelinedTraceCursor reads the source cursor on a separate parser thread
+//! @brief parsed events are passed through a lock-free ring, so parsing overlaps with the simulation
+class PipelinedTraceCursor : public ITraceCursor
+{
+public:
+  PipelinedTraceCursor(UniqTraceCursor source, size_t capacity = 1 << 14);
+  ~PipelinedTraceCursor();
+
+  bool empty() override;
+  const Event& front() override;
+  void pop() override;
+
+private:
+  UniqTraceCursor mSource;
+  SpscRing<Event> mRing;
+  Event *mFront = nullptr;
+
+  std::atomic<bool> mSourceIsOver {false};
+  std::atomic<bool> mCancelled {false};
+  std::thread mParser;
+
+  PipelinedTraceCursor(const PipelinedTraceCursor &) = delete;
+  PipelinedTraceCursor& operator =(const PipelinedTraceCursor &) = delete;
+
+  void parse();
+  bool waitFront();
+};
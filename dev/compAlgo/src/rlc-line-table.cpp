@@ -0,0 +1,90 @@
+#include "rlc-line-table.h"
+
+#include <cstring>
+#include <algorithm>
+#include <unistd.h>
+
+#include "helpers.h"
+#include "columnar-trace.h"
+#include "gzip-trace-cursor.h"
+#include "line-reader.h"
+
+const char *const RlcLineTable::header =
+    "% start	end	CellId	IMSI	RNTI	LCID	nTxPDUs	TxBytes	nRxPDUs	RxBytes	delay"
+    "	stdDev	min	max	PduSize	stdDev	min	max\n";
+
+RlcLineTable::RlcLineTable(const std::string &traceLocation)
+  : mText(traceLocation)
+{
+  if (!mText.isOpen())
+    {
+      const std::string compressedLocation = GzipTraceCursor::locationOf(traceLocation);
+      if (access(compressedLocation.c_str(), R_OK) == 0)
+        {
+          mCompressedLocation = compressedLocation;
+          return;
+        }
+
+      mColumnar.reset(new ColumnarTrace(ColumnarTrace::locationOf(traceLocation)));
+      if (!mColumnar->isValid(TraceKind::rlcStats))
+        {
+          ERR("there is neither " << traceLocation << " nor its compressed or columnar copy");
+        }
+      return;
+    }
+
+  const size_t size = mText.size();
+  const char *data = mText.data();
+  const char *end = data + size;
+  // first line dummy
+  const char *lineEnd = static_cast<const char*>(memchr(data, '\n', size));
+  for (const char *begin = lineEnd ? lineEnd + 1 : end; begin < end; begin = lineEnd + 1)
+    {
+      mLineBegins.push_back(begin - data);
+      lineEnd = static_cast<const char*>(memchr(begin, '\n', end - begin));
+      if (!lineEnd)
+        lineEnd = end;
+    }
+  mLineBegins.push_back(size + 1);
+}
+
+RlcLineTable::~RlcLineTable() = default;
+
+void RlcLineTable::write(std::ostream &stream, uint64_t index) const
+{
+  if (mColumnar)
+    {
+      using RlcColumn = ColumnarTrace::RlcColumn;
+      const uint64_t *lineNumbers = mColumnar->column<uint64_t>(RlcColumn::lineNumber);
+      const uint64_t *row = std::lower_bound(lineNumbers, lineNumbers + mColumnar->rowsCount(), index);
+      assert(row != lineNumbers + mColumnar->rowsCount() && *row == index);
+      const char *line = mColumnar->column<char>(RlcColumn::lines)
+          + mColumnar->column<uint64_t>(RlcColumn::lineOffset)[row - lineNumbers];
+      stream << line << "\n";
+      return;
+    }
+
+  assert(!isCompressed() && index + 1 < mLineBegins.size());
+  // the next line begins after the line break, the last line may have none
+  const uint64_t begin = mLineBegins[index];
+  const uint64_t end = mLineBegins[index + 1] - 1;
+  stream.write(mText.data() + begin, end - begin);
+  stream << "\n";
+}
+
+void RlcLineTable::forEachLine(const std::function<void (uint64_t, const char *, const char *)> &handle) const
+{
+  assert(isCompressed());
+  LineReader reader(mCompressedLocation);
+  const char *begin = nullptr, *end = nullptr;
+  // first line dummy
+  if (reader.nextLine(begin, end))
+    {
+      for (uint64_t index = 0; reader.nextLine(begin, end); ++index)
+        handle(index, begin, end);
+    }
+  if (!reader.isOpen() || reader.isBroken())
+    {
+      WARN("failed to inflate " << mCompressedLocation << ", the RLC output is partial");
+    }
+}
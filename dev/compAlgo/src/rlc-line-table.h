@@ -0,0 +1,45 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <iostream>
+#include <functional>
+
+#include "mapped-file.h"
+
+class ColumnarTrace;
+
+//! @class RlcLineTable gives the text of the DlRlcStats.txt lines by DlRlcPacket::index
+//! @brief the trace is mapped and its line starts are found once. If there is only the columnar copy,
+//!  its lines are looked up by the line numbers. If there is only the compressed copy of the trace,
+//!  nothing is kept in the memory: the lines cannot be written one by one, the transmitted packets are
+//!  selected instead and their lines are written in one more pass over the copy, see PacketSelection::writeLines().
+class RlcLineTable
+{
+public:
+  //! @brief the header line of DlRlcStats.txt the outputs start with
+  static const char *const header;
+
+  explicit RlcLineTable(const std::string &traceLocation);
+  ~RlcLineTable();
+
+  //! @brief writes the line with its line break
+  //! @note not available if the trace is compressed
+  void write(std::ostream &stream, uint64_t index) const;
+
+  bool isCompressed() const { return !mCompressedLocation.empty(); }
+  //! @brief inflates the compressed trace once more and gives every line after the header by its index
+  void forEachLine(const std::function<void (uint64_t index, const char *begin, const char *end)> &handle) const;
+
+private:
+  MappedFile mText;
+  std::string mCompressedLocation; //< if there is only the compressed copy
+  std::vector<uint64_t> mLineBegins; //< of the lines after the header and the end of the last one
+  std::unique_ptr<ColumnarTrace> mColumnar;
+
+  RlcLineTable(const RlcLineTable &) = delete;
+  RlcLineTable& operator =(const RlcLineTable &) = delete;
+};
+
+using RlcLinesPtr = std::shared_ptr<const RlcLineTable>;
@@ -0,0 +1,88 @@
+#include "sim-context.h"
+
+SimContext::SimContext(const std::string &inputDir, const std::string &outputDir,
+                       const AlgoConfig &algoConfig)
+  : mTimers(*this)
+  , mX2Channel(*this)
+  , mAlgoConfig(algoConfig)
+  , mInputDir(inputDir)
+  , mOutputDir(outputDir)
+  , mDiscardedOutput(nullptr)
+  , mFileLogger(outputDir.empty()? "" : outputDir + "/log.log", mOutputWriter)
+{
+  resetEventQueue({});
+}
+
+void SimContext::resetEventQueue(const std::vector<Event> &events)
+{
+  switch (SimConfig::eventQueueType)
+    {
+    case SimConfig::binaryHeap:
+      mEventQueue.reset(new HeapEventQueue);
+      break;
+    case SimConfig::timingWheel:
+      mEventQueue.reset(new TimingWheelEventQueue);
+      break;
+    }
+
+  for (const Event &event : events)
+    mEventQueue->push(event);
+}
+
+void SimContext::setTime(Time newTime)
+{
+  mCurrentTime = newTime;
+}
+
+void SimContext::scheduleEvent(const Event &event)
+{
+  assert(event.atTime >= mCurrentTime);
+  if (event.atTime >= mHorizon)
+    mOutbox->push_back(event);
+  else
+    mEventQueue->push(event);
+}
+
+void SimContext::setHorizon(Time horizon, std::vector<Event> *outbox)
+{
+  assert(outbox);
+  mHorizon = horizon;
+  mOutbox = outbox;
+}
+
+std::string SimContext::inputLocation(const std::string &file) const
+{
+  return mInputDir + "/" + file;
+}
+
+std::ostream &SimContext::outputFile(const std::string &file, const std::string &header)
+{
+  if (mOutputDir.empty() && !mOutputRouter)
+    return mDiscardedOutput;
+
+  auto &stream = mOutputFiles[file];
+  if (!stream)
+    {
+      if (mOutputRouter)
+        stream.reset(new std::ostream(mOutputRouter(file)));
+      else
+        stream.reset(new std::ostream(mOutputWriter.open(mOutputDir + "/" + file)));
+      *stream << header;
+      if (mOutputsMuted)
+        stream->setstate(std::ios_base::badbit);
+    }
+  return *stream;
+}
+
+void SimContext::setOutputsMuted(bool muted)
+{
+  mOutputsMuted = muted;
+  for (auto &file : mOutputFiles)
+    {
+      // a stream in bad state skips the formatting of the records as well
+      if (muted)
+        file.second->setstate(std::ios_base::badbit);
+      else
+        file.second->clear();
+    }
+}
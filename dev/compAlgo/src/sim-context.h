@@ -0,0 +1,89 @@
+#pragma once
+
+#include <string>
+#include <fstream>
+#include <map>
+#include <vector>
+#include <limits>
+#include <functional>
+
+#include "helpers.h"
+#include "event-queue.h"
+#include "memory-arena.h"
+#include "timer-service.h"
+#include "rlc-line-table.h"
+#include "output-writer.h"
+#include "lteEnb/x2-channel.h"
+
+//! @class SimContext owns everything one simulation shares between its modules:
+//!  the clock, the event queue, the timers, the X2 channel, the output files
+//!  with their writer thread and the memory arena of the containers that grow and shrink along the run.
+//!  Several contexts may live in one process independently.
+class SimContext
+{
+public:
+  //! @arg outputDir empty to discard all the output files
+  SimContext(const std::string &inputDir, const std::string &outputDir,
+             const AlgoConfig &algoConfig = AlgoConfig());
+
+  const AlgoConfig& algoConfig() const { return mAlgoConfig; }
+  //! @note the arena outlives the modules of the simulation, they are destroyed before the context
+  MemoryArena& arena() { return mArena; }
+
+  Time getTime() const { return mCurrentTime; }
+  void setTime(Time newTime);
+
+  void scheduleEvent(const Event &event);
+  IEventQueue& eventQueue() { return *mEventQueue; }
+  //! @brief replaces the queue by a new one with the events, equal time events keep their order
+  //! @note the timing wheel cannot take events before its current time, so it is not refilled in place
+  void resetEventQueue(const std::vector<Event> &events);
+  //! @brief events at or after the horizon are put to the outbox instead of the event queue
+  void setHorizon(Time horizon, std::vector<Event> *outbox);
+
+  TimerService& timers() { return mTimers; }
+  X2Channel& x2Channel() { return mX2Channel; }
+
+  std::string inputLocation(const std::string &file) const;
+  //! @brief lines of the RLC trace, the text output of the transmitted packets is made of them
+  void setRlcLines(RlcLinesPtr rlcLines) { mRlcLines = rlcLines; }
+  const RlcLineTable& rlcLines() const { assert(mRlcLines); return *mRlcLines; }
+
+  //! @return false if all the output files are discarded
+  bool hasOutputs() const { return !mOutputDir.empty() || mOutputRouter; }
+  //! @brief file of the output directory, it is truncated and given the header on the first request
+  std::ostream& outputFile(const std::string &file, const std::string &header);
+  //! @return location of a file of the output directory written besides outputFile()
+  std::string outputLocation(const std::string &file) const { return mOutputDir + "/" + file; }
+  FileLogger& fileLogger() { return mFileLogger; }
+  //! @brief records to the output files are dropped while muted, e.g. during a warm-up
+  void setOutputsMuted(bool muted);
+  bool outputsMuted() const { return mOutputsMuted; }
+
+  using OutputRouter = std::function<std::streambuf* (const std::string &file)>;
+  //! @brief output files requested later go to the buffers of the router, not to the output directory
+  void routeOutputs(OutputRouter router) { mOutputRouter = router; }
+
+private:
+  MemoryArena mArena;  //< first to be destroyed last
+  Time mCurrentTime = Converter::milliseconds(0);
+  UniqEventQueue mEventQueue;
+  Time mHorizon = std::numeric_limits<Time>::max();
+  std::vector<Event> *mOutbox = nullptr;
+  TimerService mTimers;
+  X2Channel mX2Channel;
+
+  const AlgoConfig mAlgoConfig;
+  const std::string mInputDir;
+  RlcLinesPtr mRlcLines;
+  const std::string mOutputDir;
+  OutputWriter mOutputWriter; //< outlives the streams over its buffers
+  std::map<std::string, std::unique_ptr<std::ostream>> mOutputFiles;
+  OutputRouter mOutputRouter;
+  bool mOutputsMuted = false;
+  std::ostream mDiscardedOutput; //< has no buffer, writes are dropped before formatting
+  FileLogger mFileLogger;
+
+  SimContext(const SimContext &) = delete;
+  SimContext& operator =(const SimContext &) = delete;
+};
@@ -2,74 +2,78 @@
 
 #include <iostream>
 #include <fstream>
-#include <sstream>
+#include <limits>
+#include <algorithm>
 #include <assert.h>
-#include <math.h>
 
-#include "lteEnb/x2-channel.h"
+#include "pipelined-trace-cursor.h"
 
-Simulator* Simulator::mSimulator = nullptr;
-
-Simulator *Simulator::instance()
+namespace
 {
-  if (!mSimulator)
-    mSimulator = new Simulator;
-
-  return mSimulator;
+  const char *const checkpointSignature = "compAlgo checkpoint";
+  const uint32_t checkpointVersion = 8;
 }
 
-Simulator::Simulator()
+Simulator::Simulator(const std::string &inputDir, const std::string &outputDir, Time replayFrom, Time replayTo)
+  : mContext(inputDir, outputDir)
+  , mL2MacFlat(mContext)
+  , mReplayFrom(replayFrom)
+  , mReplayTo(replayTo)
 {
+  assert(replayFrom < replayTo);
+  if (SimConfig::rlcOutputMode == SimConfig::rlcTextOutput && mContext.hasOutputs())
+    mContext.setRlcLines(std::make_shared<RlcLineTable>(mContext.inputLocation("DlRlcStats.txt")));
+  if (replayFrom)
+    {
+      const Time warmUp = mL2MacFlat.warmUpDuration();
+      mReplayStart = replayFrom > warmUp ? replayFrom - warmUp : 0;
+      mIsWarmingUp = true;
+      mContext.setOutputsMuted(true);
+      LOG("replay from " << replayFrom << " [us], warm-up from " << mReplayStart << " [us]");
+    }
+
+  if (SimConfig::traceInputMode != SimConfig::preloadTraces)
+    {
+      UniqTraceCursor traces = MergedTraceCursor::openScenario(inputDir, mReplayStart);
+
+      // parser thread only competes with the simulation on a single core
+      if (SimConfig::traceInputMode == SimConfig::pipelineTraces && std::thread::hardware_concurrency() > 1)
+        mTraceCursor.reset(new PipelinedTraceCursor(std::move(traces)));
+      else
+        mTraceCursor = std::move(traces);
+      return;
+    }
+
   parseMacTraffic();
   parseMeasurements();
 
-  scheduleEvent(Event(EventType::stopSimulation, mStopTime + Converter::milliseconds(100)));
+  mContext.scheduleEvent(Event(EventType::stopSimulation, stopTime()));
+  mStopScheduled = true;
+}
+
+Simulator::Simulator(TraceBufferPtr traces, const std::string &outputDir, const AlgoConfig &algoConfig)
+  : mContext("", outputDir, algoConfig)
+  , mTraceCursor(new TraceBufferCursor(traces))
+  , mL2MacFlat(mContext)
+{
+  mContext.setRlcLines(traces->rlcLines());
 }
 
 void Simulator::parseMacTraffic()
 {
   LOG("start parsing mac traffic...");
-  std::string location = "./input/" + std::to_string(SimConfig::timeInterval) +  "/DlRlcStats.txt";
-  std::fstream rlcStats;
-  rlcStats.open(location, std::ios_base::in);
-  assert(rlcStats.is_open());
-
-  std::string line;
-  std::getline(rlcStats, line); // first line dummy
+  UniqTraceCursor rlcStats = openTrace(mContext.inputLocation("DlRlcStats.txt"), TraceKind::rlcStats, 0,
+                                       std::thread::hardware_concurrency());
 
-  while (std::getline(rlcStats, line))
+  for (; !rlcStats->empty(); rlcStats->pop())
     {
-      if (line.size() < 15)
-        {
-          WARN("drop line: " << line);
-          continue;
-        }
-
-      std::stringstream stream(line);
-      /*
-       *  % start end CellId IMSI RNTI LCID nTxPDUs TxBytes nRxPDUs RxBytes delay ... etc
-       */
-      double timeBegin; // seconds
-      double timeEnd; // seconds
-      int cellId, imsi, rnti, lcid, nTxPdu, txBytes, nRxPdu, rxBytes;
-
-      stream >> timeBegin >> timeEnd >> cellId >> imsi >> rnti >> lcid >> nTxPdu >> txBytes >> nRxPdu >> rxBytes;
-      if (cellId > 3)
+      const Event &event = rlcStats->front();
+      if (!isReplayed(event.atTime))
         continue;
 
-      Time timeUSec = static_cast<uint64_t>(round(timeBegin * 1000) * 1000);
-
-//      assert((nTxPdu == 1 || nTxPdu == 0) && (nRxPdu == 0 || nRxPdu == 1));
-      DlRlcPacket packet;
-      packet.dlRlcStatLine = line;
-
-      Event event(EventType::scheduleAttempt, timeUSec);
-      event.cellId = cellId;
-      event.packet = packet;
-
       if (event.atTime > mStopTime)
         mStopTime = event.atTime;
-      mEventQueue.push(event);
+      mContext.eventQueue().push(event);
     }
 
   LOG("parsing mac traffic done");
@@ -78,118 +82,251 @@ void Simulator::parseMacTraffic()
 void Simulator::parseMeasurements()
 {
   LOG("start parsing measurements...");
-  std::string location = "./input/" + std::to_string(SimConfig::timeInterval) +  "/measurements.log";
-  std::fstream measurements;
-  measurements.open(location, std::ios_base::in);
-  assert(measurements.is_open());
+  UniqTraceCursor measurements = openTrace(mContext.inputLocation("measurements.log"), TraceKind::measurements, 0,
+                                           std::thread::hardware_concurrency());
 
-  std::string line;
-  std::getline(measurements, line); // first line dummy
-
-  while (std::getline(measurements, line))
+  for (; !measurements->empty(); measurements->pop())
     {
-      if (line.size() < 7)
-        {
-          WARN("warn: drop line: \"" << line << "\"");
-          continue;
-        }
-
-      std::stringstream stream(line);
-
-      Time timeUSec;
-      int sCellId, tCellId, rsrp;
-      stream >> timeUSec >> sCellId >> tCellId >> rsrp;
-      if (sCellId > 3 || tCellId > 3)
+      const Event &event = measurements->front();
+      if (!isReplayed(event.atTime))
         continue;
 
-      CSIMeasurementReport report;
-      report.targetCellId = tCellId;
-      report.csi = std::make_pair(timeUSec, rsrp);
+      if (event.atTime > mStopTime)
+        mStopTime = event.atTime;
+      mContext.eventQueue().push(event);
+    }
 
-      Event event(EventType::csiIndicator, timeUSec);
-      event.cellId = sCellId;
-      event.report = report;
+  LOG("measurements parsing done");
+}
 
+bool Simulator::popEvent(Event &event)
+{
+  IEventQueue &eventQueue = mContext.eventQueue();
+  const bool hasTraceEvents = mTraceCursor && !mTraceCursor->empty() && mTraceCursor->front().atTime < mReplayTo;
+  if (!hasTraceEvents && !mStopScheduled)
+    {
+      LOG("input traces are over");
+      mContext.scheduleEvent(Event(EventType::stopSimulation, stopTime()));
+      mStopScheduled = true;
+    }
+
+  // on equal time trace goes first, same as it was pushed before the run in preload mode
+  if (hasTraceEvents && (eventQueue.empty() || mTraceCursor->front().atTime <= eventQueue.nextTime()))
+    {
+      event = mTraceCursor->front();
+      mTraceCursor->pop();
       if (event.atTime > mStopTime)
         mStopTime = event.atTime;
-      mEventQueue.push(event);
+      return true;
     }
 
-  LOG("measurements parsing done");
+  if (eventQueue.empty())
+    return false;
+
+  event = eventQueue.pop();
+  return true;
 }
 
-void Simulator::postProcessing()
+bool Simulator::hasEventAt(Time time)
 {
-  LOG("Stop event was reached\n" << "\tStill scheduled in queue " << mEventQueue.size() << " events");
+  if (mTraceCursor && !mTraceCursor->empty() && mTraceCursor->front().atTime == time)
+    return true;
+  return !mContext.eventQueue().empty() && mContext.eventQueue().nextTime() == time;
 }
 
-Simulator::~Simulator()
+Time Simulator::nextEventTime()
 {
-  X2Channel::destroy();
+  Time result = std::numeric_limits<Time>::max();
+  if (mTraceCursor && !mTraceCursor->empty())
+    result = mTraceCursor->front().atTime;
+  if (!mContext.eventQueue().empty())
+    result = std::min(result, mContext.eventQueue().nextTime());
+  return result;
+}
+
+void Simulator::setCheckpoint(Time atTime, const std::string &location)
+{
+  assert(!location.empty());
+  mCheckpointTime = atTime;
+  mCheckpointLocation = location;
+}
+
+void Simulator::saveCheckpoint()
+{
+  LOG("saving checkpoint at " << mContext.getTime() << " [us] to " << mCheckpointLocation);
+  std::fstream file(mCheckpointLocation, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+  assert(file.is_open());
+  CheckpointWriter writer(file);
+
+  writer.write(std::string(checkpointSignature));
+  writer.write(checkpointVersion);
+  writer.write(mCheckpointTime);
+  writer.write(mContext.getTime());
+  writer.write(mStopTime);
+  writer.write(mStopScheduled);
+  writer.write(mProcessedEvents);
+  writer.write(!mTraceCursor); //< the rest of the traces is in the queue
+
+  // the queue can only be read by popping, so it is refilled afterwards
+  std::vector<Event> events;
+  events.reserve(mContext.eventQueue().size());
+  while (!mContext.eventQueue().empty())
+    events.push_back(mContext.eventQueue().pop());
+  mContext.resetEventQueue(events);
+
+  writer.write(events);
+
+  mContext.timers().saveState(writer);
+  mContext.x2Channel().saveState(writer);
+  mL2MacFlat.saveState(writer);
+
+  file.flush();
+  if (!writer.good())
+    {
+      ERR("failed to write checkpoint " << mCheckpointLocation);
+    }
+  mCheckpointLocation.clear();
+}
+
+void Simulator::restore(const std::string &location)
+{
+  LOG("restoring checkpoint " << location);
+  std::fstream file(location, std::ios_base::in | std::ios_base::binary);
+  assert(file.is_open());
+  CheckpointReader reader(file);
+
+  std::string signature;
+  uint32_t version = 0;
+  reader.read(signature);
+  reader.read(version);
+  if (signature != checkpointSignature || version != checkpointVersion)
+    {
+      ERR("not a checkpoint of this version: " << location);
+    }
+
+  Time checkpointTime = 0, currentTime = 0;
+  reader.read(checkpointTime);
+  reader.read(currentTime);
+  reader.read(mStopTime);
+  reader.read(mStopScheduled);
+  reader.read(mProcessedEvents);
+  bool hasQueuedTraces = false;
+  reader.read(hasQueuedTraces);
+  mContext.setTime(currentTime);
+
+  // in preload mode the saved queue holds the rest of the traces
+  std::vector<Event> events;
+  reader.read(events);
+  mContext.resetEventQueue(events);
+
+  mContext.timers().loadState(reader);
+  mContext.x2Channel().loadState(reader);
+  mL2MacFlat.loadState(reader);
+
+  if (!reader.good())
+    {
+      ERR("broken checkpoint " << location);
+    }
+
+  if (hasQueuedTraces)
+    mTraceCursor.reset();
+  else if (!mTraceCursor)
+    {
+      ERR("checkpoint of a run on streamed traces cannot be restored with preloaded ones");
+    }
 
-  LOG("Simulation time: " << (mTimeMeasurement.average("run") / 1000 / 1000) << " [s]\n");
+  // the traces before the checkpoint have been processed by the saved run
+  if (mTraceCursor)
+    while (!mTraceCursor->empty() && mTraceCursor->front().atTime < checkpointTime)
+      mTraceCursor->pop();
+
+  mIsRestored = true;
+}
+
+void Simulator::postProcessing()
+{
+  LOG("Stop event was reached\n" << "\tStill scheduled in queue " << mContext.eventQueue().size() << " events");
+  if (!mCheckpointLocation.empty())
+    WARN("the run has stopped before the checkpoint time " << mCheckpointTime);
 }
 
-void Simulator::destroy()
+Simulator::~Simulator()
 {
-  delete mSimulator;
-  mSimulator = nullptr;
+  const double runTime = mTimeMeasurement.average("run") / 1000 / 1000;
+  LOG("Simulation time: " << runTime << " [s]");
+  LOG("Processed events: " << mProcessedEvents << "\t(" << mProcessedEvents / runTime << " [events/s], "
+      << mContext.eventQueue().name() << ")");
+  LOG("Arena allocations: " << mContext.arena().allocationsCount() << "\t("
+      << mContext.arena().upstreamAllocationsCount() << " from the heap)\n");
+
+  if (SimConfig::rlcOutputMode == SimConfig::rlcTextOutput && mContext.hasOutputs() && mContext.rlcLines().isCompressed())
+    mL2MacFlat.transmitted().writeLines(mContext.rlcLines(), mContext.outputFile("DlRlcStats.txt", RlcLineTable::header));
+  if (SimConfig::rlcOutputMode == SimConfig::rlcSelectionOutput && mContext.hasOutputs()
+      && !mL2MacFlat.transmitted().save(mContext.outputLocation("DlRlcStats.sel")))
+    {
+      WARN("failed to write " << mContext.outputLocation("DlRlcStats.sel"));
+    }
 }
 
 void Simulator::run()
 {
   const std::string fname = "run";
   LOG("\n\tSimulation has been started...\n");
-  mL2MacFlat.activateDlCompFeature();
-  SimTimeProvider::setTime(Converter::milliseconds(0));
+  if (!mIsRestored)
+    {
+      mL2MacFlat.activateDlCompFeature();
+      mContext.setTime(Converter::milliseconds(0));
+    }
 
   mTimeMeasurement.start(fname);
 
-  int processedEvents = 0;
-  while (!mEventQueue.empty())
+  size_t processedEvents = 0;
+  Event event;
+  while (true)
     {
-      Event event = mEventQueue.top();
-      mEventQueue.pop();
-      SimTimeProvider::setTime(event.atTime);
-      switch(event.eventType)
+      if (!mCheckpointLocation.empty() && nextEventTime() >= mCheckpointTime)
+        saveCheckpoint();
+      if (!popEvent(event))
+        break;
+
+      // all events of the subframe are taken at once, schedule attempts go to L2Mac as one batch
+      mContext.setTime(event.atTime);
+      if (mIsWarmingUp && event.atTime >= mReplayFrom)
         {
-          case EventType::stopSimulation:
-          {
-            postProcessing();
-            mTimeMeasurement.stop(fname);
-            return;
-          }
-        case EventType::x2Message:
-          {
-            mL2MacFlat.recvX2Message(event.cellId, event.message);
-            break;
-          }
-        case EventType::csiIndicator:
-          {
-            mL2MacFlat.recvMeasurementsReport(event.cellId, event.report);
-            break;
-          }
-        case EventType::scheduleAttempt:
-          {
-            mL2MacFlat.makeScheduleDecision(event.cellId, event.packet);
-            break;
-          }
-        case EventType::l2Timeout:
-          mL2MacFlat.l2Timeout(event.cellId);
-          break;
+          mIsWarmingUp = false;
+          mContext.setOutputsMuted(false);
         }
+      mScheduleAttempts.clear();
+      mTickEvents.clear();
+      do
+        {
+          if (event.eventType == EventType::scheduleAttempt)
+            mScheduleAttempts.push_back(event);
+          else
+            mTickEvents.push_back(event);
+        }
+      while (hasEventAt(event.atTime) && popEvent(event));
+
+      if (!mScheduleAttempts.empty())
+        mL2MacFlat.makeScheduleDecisions(mScheduleAttempts);
 
-      ++processedEvents;
-      if (processedEvents % (100 * 1000) == 0)
+      for (const Event &tickEvent : mTickEvents)
         {
-          LOG("\tevents remaining:\t" << mEventQueue.size());
+          if (tickEvent.eventType == EventType::stopSimulation)
+            {
+              postProcessing();
+              mTimeMeasurement.stop(fname);
+              return;
+            }
+          mL2MacFlat.dispatch(tickEvent);
+        }
+
+      processedEvents += mScheduleAttempts.size() + mTickEvents.size();
+      mProcessedEvents += mScheduleAttempts.size() + mTickEvents.size();
+      if (processedEvents >= 100 * 1000)
+        {
+          LOG("\tevents remaining:\t" << mContext.eventQueue().size());
           processedEvents = 0;
         }
     }
 }
-
-void Simulator::scheduleEvent(Event event)
-{
-  assert(event.atTime >= SimTimeProvider::getTime());
-  mEventQueue.push(event);
-}
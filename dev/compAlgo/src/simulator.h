@@ -1,35 +1,71 @@
 #pragma once
 
+#include <limits>
+
 #include "helpers.h"
+#include "sim-context.h"
+#include "trace-cursor.h"
+#include "trace-buffer.h"
 #include "lteEnb/l2-mac.h"
 
 class Simulator
 {
 public:
-  static Simulator* instance();
-  static void destroy();
+  //! @arg replayFrom, replayTo range of the traces to replay, the outputs start at replayFrom.
+  //!  The traces are read from L2Mac::warmUpDuration() before replayFrom for the decisions to settle.
+  Simulator(const std::string &inputDir = "./input/" + std::to_string(SimConfig::traceInterval),
+            const std::string &outputDir = "./output",
+            Time replayFrom = 0, Time replayTo = std::numeric_limits<Time>::max());
+  //! @brief runs on the traces parsed beforehand, the buffer may be shared with other simulators
+  Simulator(TraceBufferPtr traces, const std::string &outputDir, const AlgoConfig &algoConfig);
+  ~Simulator();
 
   void run();
+  MacStatistics statistics() const { return mL2MacFlat.statistics(); }
 
-  void scheduleEvent(Event event);
+  //! @brief the state is saved once all the events before atTime are processed, then the run goes on
+  void setCheckpoint(Time atTime, const std::string &location);
+  //! @brief continues the saved run instead of starting from zero, call before run()
+  //! @note output files get only the records after the checkpoint, the algorithm parameters
+  //!  are the ones of this simulator, so several variants may be forked from one checkpoint
+  void restore(const std::string &location);
 
 private:
-  using EventQueue = std::priority_queue<Event, std::deque<Event>, std::greater<Event>>;
-
-  static Simulator* mSimulator;
-  EventQueue mEventQueue;
+  SimContext mContext;
+  UniqTraceCursor mTraceCursor;        //< not used if traces are preloaded
   L2Mac mL2MacFlat;
   Time mStopTime = Converter::seconds(0);
+  bool mStopScheduled = false;
+  const Time mReplayFrom = 0;
+  const Time mReplayTo = std::numeric_limits<Time>::max();
+  Time mReplayStart = 0;                //< the warm-up begins
+  bool mIsWarmingUp = false;            //< the outputs are muted
   TimeMeasurement mTimeMeasurement;
+  uint64_t mProcessedEvents = 0;
+
+  Time mCheckpointTime = std::numeric_limits<Time>::max();
+  std::string mCheckpointLocation;   //< empty if no checkpoint is pending
+  bool mIsRestored = false;
+
+  std::vector<Event> mScheduleAttempts; //< of the current subframe
+  std::vector<Event> mTickEvents;       //< other events of the current subframe in order
 
-  Simulator();
-  ~Simulator();
   Simulator(const Simulator &) = delete;
   Simulator& operator =(const Simulator &) = delete;
 
+  bool isReplayed(Time time) const { return time >= mReplayStart && time < mReplayTo; }
+  Time stopTime() const { return std::min(mStopTime + Converter::milliseconds(100), mReplayTo); }
+
   void parseMacTraffic();
   void parseMeasurements();
 
+  //! @brief merges the trace cursor with the scheduled events by time
+  bool popEvent(Event &event);
+  bool hasEventAt(Time time);
+  Time nextEventTime();
+
+  void saveCheckpoint();
+
   void postProcessing();
 };
 
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <assert.h>
+
+//! @class SpscRing is a lock-free bounded queue for one producer and one consumer thread
+//! @brief slots are filled and read in place, so they may keep reusable buffers
+template <typename T>
+class SpscRing
+{
+public:
+  //! @arg capacity must be a power of two
+  explicit SpscRing(size_t capacity)
+    : mSlots(capacity)
+    , mMask(capacity - 1)
+  {
+    assert(capacity && !(capacity & mMask));
+  }
+
+  //! @return slot to fill by producer or nullptr if the ring is full
+  T* producerSlot()
+  {
+    const size_t tail = mTail.load(std::memory_order_relaxed);
+    if (tail - mCachedHead == mSlots.size())
+      {
+        mCachedHead = mHead.load(std::memory_order_acquire);
+        if (tail - mCachedHead == mSlots.size())
+          return nullptr;
+      }
+    return &mSlots[tail & mMask];
+  }
+
+  //! @brief hands the filled slot over to consumer
+  void publish()
+  {
+    mTail.store(mTail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+  //! @return the oldest published and not consumed slot or nullptr if there is none
+  T* consumerSlot()
+  {
+    if (mRead == mCachedTail)
+      {
+        mCachedTail = mTail.load(std::memory_order_acquire);
+        if (mRead == mCachedTail)
+          return nullptr;
+      }
+    return &mSlots[mRead & mMask];
+  }
+
+  //! @brief moves to the next slot and gives the consumed one back to producer,
+  //!  the pointer of consumerSlot() is not valid after that
+  void consume()
+  {
+    mHead.store(++mRead, std::memory_order_release);
+  }
+
+private:
+  std::vector<T> mSlots;
+  const size_t mMask;
+
+  // the other side's position is cached to touch the shared cache line only when needed
+  std::atomic<size_t> mHead {0}; //< written by consumer only
+  size_t mRead = 0;              //< consumer only
+  size_t mCachedTail = 0;        //< consumer only
+  char mFalseSharingGuard[64];   //< keeps consumer and producer data on different cache lines
+  std::atomic<size_t> mTail {0}; //< written by producer only
+  size_t mCachedHead = 0;        //< producer only
+
+  SpscRing(const SpscRing &) = delete;
+  SpscRing& operator =(const SpscRing &) = delete;
+};
@@ -0,0 +1,169 @@
+#include "sweep-runner.h"
+
+#include <sstream>
+#include <thread>
+#include <functional>
+#include <algorithm>
+#include <map>
+#include <limits>
+#include <cerrno>
+#include <cstdlib>
+
+#include "simulator.h"
+
+namespace
+{
+  // in the order of SimConfig::DecisionAlgo
+  const std::vector<std::string> algoNames {
+      "naive", "interpolation", "wmaRaw", "smmRaw", "kamaRaw", "kamaPure", "hybrid"
+      , "chebyshevApprx", "leastSquaresRegression"
+  };
+
+  //! @return false if the name is not of an algorithm
+  bool parseAlgo(const std::string &name, SimConfig::DecisionAlgo &algo)
+  {
+    for (size_t i = 0; i < algoNames.size(); i++)
+      {
+        if (algoNames[i] == name)
+          {
+            algo = static_cast<SimConfig::DecisionAlgo>(i);
+            return true;
+          }
+      }
+    return false;
+  }
+
+  //! @return false if the text is not a whole number in the range of int
+  bool parseInt(const std::string &text, int &value)
+  {
+    char *end = nullptr;
+    errno = 0;
+    const long number = strtol(text.c_str(), &end, 10);
+    if (end == text.c_str() || *end || errno == ERANGE
+        || number < std::numeric_limits<int>::min() || number > std::numeric_limits<int>::max())
+      return false;
+    value = static_cast<int>(number);
+    return true;
+  }
+
+  //! @return false if the value does not parse
+  using FieldSetter = std::function<bool (AlgoConfig&, const std::string&)>;
+
+  FieldSetter intField(int AlgoConfig::*field)
+  {
+    return [field] (AlgoConfig &config, const std::string &value) { return parseInt(value, config.*field); };
+  }
+
+  const std::map<std::string, FieldSetter> fieldSetters {
+      {"algoType", [] (AlgoConfig &config, const std::string &value) { return parseAlgo(value, config.algoType); }}
+      , {"wmaSmmDuration", intField(&AlgoConfig::wmaSmmDuration)}
+      , {"approxAlgoWindowSize", intField(&AlgoConfig::approxAlgoWindowSize)}
+      , {"approxAlgoXOffset", intField(&AlgoConfig::approxAlgoXOffset)}
+      , {"kamaN", intField(&AlgoConfig::kamaN)}
+      , {"kamaF", intField(&AlgoConfig::kamaF)}
+      , {"kamaS", intField(&AlgoConfig::kamaS)}
+  };
+}
+
+SweepRunner::SweepRunner(const std::string &inputDir, const std::string &outputDir)
+  : mInputDir(inputDir)
+  , mOutputDir(outputDir)
+{
+}
+
+void SweepRunner::loadGrid(const std::string &location)
+{
+  std::fstream grid(location, std::ios_base::in);
+  if (!grid.is_open())
+    {
+      ERR("cannot open the sweep grid " << location);
+    }
+
+  std::vector<AlgoConfig> configs {AlgoConfig()};
+  std::string line;
+  while (std::getline(grid, line))
+    {
+      std::stringstream stream(line.substr(0, line.find('%')));
+      std::string field;
+      if (!(stream >> field))
+        continue;
+
+      auto setter = fieldSetters.find(field);
+      if (setter == fieldSetters.end())
+        {
+          ERR("unknown sweep parameter: " << field);
+        }
+
+      std::vector<AlgoConfig> product;
+      std::string value;
+      while (stream >> value)
+        {
+          for (AlgoConfig config : configs)
+            {
+              if (!setter->second(config, value))
+                {
+                  ERR("bad value of the sweep parameter " << field << ": " << value);
+                }
+              product.push_back(config);
+            }
+        }
+      if (!product.empty())
+        configs.swap(product);
+    }
+
+  mConfigs.insert(mConfigs.end(), configs.begin(), configs.end());
+}
+
+void SweepRunner::run(size_t threadsCount)
+{
+  if (!threadsCount)
+    threadsCount = std::max(std::thread::hardware_concurrency(), 1u);
+  threadsCount = std::min(threadsCount, mConfigs.size());
+
+  LOG("sweep: parsing traces of " << mInputDir << "...");
+  TraceBufferPtr traces(new TraceBuffer(*MergedTraceCursor::openScenario(mInputDir, 0, std::thread::hardware_concurrency())));
+  LOG("sweep: " << traces->size() << " events, " << mConfigs.size() << " configurations on "
+      << threadsCount << " threads");
+
+  mResults.assign(mConfigs.size(), MacStatistics());
+  mNextConfig = 0;
+  std::vector<std::thread> workers;
+  for (size_t i = 0; i < threadsCount; i++)
+    workers.emplace_back(&SweepRunner::work, this, traces);
+  for (auto &worker : workers)
+    worker.join();
+
+  writeSummary();
+  LOG("sweep: done, see " << mOutputDir << "/sweep.log");
+}
+
+void SweepRunner::work(TraceBufferPtr traces)
+{
+  // logs of the concurrent simulations would only interleave
+  ScopedLogMute logMute;
+  for (size_t i = mNextConfig++; i < mConfigs.size(); i = mNextConfig++)
+    {
+      Simulator simulator(traces, "", mConfigs[i]);
+      simulator.run();
+      mResults[i] = simulator.statistics();
+    }
+}
+
+void SweepRunner::writeSummary()
+{
+  std::fstream summary(mOutputDir + "/sweep.log", std::ios_base::out | std::ios_base::trunc);
+  assert(summary.is_open());
+
+  summary << "% algoType\twmaSmmDuration\tapproxAlgoWindowSize\tapproxAlgoXOffset\tkamaN\tkamaF\tkamaS"
+             "\taveThroughput[Kbps]\tmaxThroughput[Kbps]\tswitches\tmissedFrames\n";
+  for (size_t i = 0; i < mConfigs.size(); i++)
+    {
+      const AlgoConfig &config = mConfigs[i];
+      const MacStatistics &result = mResults[i];
+      summary << algoNames[config.algoType] << "\t" << config.wmaSmmDuration << "\t"
+              << config.approxAlgoWindowSize << "\t" << config.approxAlgoXOffset << "\t"
+              << config.kamaN << "\t" << config.kamaF << "\t" << config.kamaS << "\t"
+              << result.aveThroughputKbps << "\t" << result.maxThroughputKbps << "\t"
+              << result.cellSwitches << "\t" << result.missedFrames << "\n";
+    }
+}
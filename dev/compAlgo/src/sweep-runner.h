@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <atomic>
+
+#include "helpers.h"
+#include "trace-buffer.h"
+#include "lteEnb/l2-mac.h"
+
+//! @class SweepRunner runs a grid of AlgoConfig on one scenario in parallel
+//! @brief the traces are parsed once and shared, every worker thread runs its own Simulator.
+//!  Per-run output files are not written, sweep.log gets one summary row per configuration.
+class SweepRunner
+{
+public:
+  SweepRunner(const std::string &inputDir, const std::string &outputDir);
+
+  //! @brief grid file lines are "<AlgoConfig field> <value> <value> ...", '%' starts a comment.
+  //!  Every combination of the values makes a configuration, unlisted fields keep the defaults.
+  void loadGrid(const std::string &location);
+
+  //! @arg threadsCount 0 to take all the hardware threads
+  void run(size_t threadsCount = 0);
+
+private:
+  const std::string mInputDir;
+  const std::string mOutputDir;
+  std::vector<AlgoConfig> mConfigs;
+  std::vector<MacStatistics> mResults;
+  std::atomic<size_t> mNextConfig {0};
+
+  SweepRunner(const SweepRunner &) = delete;
+  SweepRunner& operator =(const SweepRunner &) = delete;
+
+  void work(TraceBufferPtr traces);
+  void writeSummary();
+};
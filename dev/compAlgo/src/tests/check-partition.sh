@@ -0,0 +1,41 @@
+#!/bin/bash
+# Checks that --partition writes the same outputs as the sequential run, with 1 to 3 threads.
+# Runs on the scenario of ./input as run_postsim.sh prepares it, and on a copy of it where all the cells
+# report in the same microsecond, so that their X2 messages to the leader arrive at equal times.
+# usage: check-partition.sh [compAlgo binary]
+
+DIR=$(cd "$(dirname "$0")" && pwd)
+COMP_ALGO=$(readlink -f "${1:-$DIR/../../build/release/bin/compAlgo}")
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+cd "$DIR/../.." || exit 1
+mkdir -p "$WORK/equal-times/output" "$WORK/sequential"
+for interval in input/*/; do
+  mkdir -p "$WORK/equal-times/$interval"
+  cp "$interval"DlRlcStats.txt "$WORK/equal-times/$interval"
+  period=$(( $(basename "$interval") * 1000 )) # [us]
+  awk -v period=$period 'BEGIN { OFS = "\t" } /^%/ { print; next } { $1 = $1 - $1 % period + 37; print }' \
+    "$interval"measurements.log > "$WORK/equal-times/$interval"measurements.log
+done
+
+status=0
+for scenario in "$PWD" "$WORK/equal-times"; do
+  cd "$scenario" || exit 1
+  mkdir -p output
+  rm -f output/* "$WORK"/sequential/*
+  "$COMP_ALGO" > /dev/null 2>&1 || { echo "partition: the sequential run failed in $scenario"; exit 1; }
+  cp output/* "$WORK/sequential/"
+
+  for threads in 1 2 3; do
+    rm -f output/*
+    "$COMP_ALGO" --partition $threads > /dev/null 2>&1 || { echo "partition: the run on $threads threads failed"; exit 1; }
+    if diff -r -q "$WORK/sequential" output; then
+      echo "partition on $threads threads ($(basename "$scenario")): OK"
+    else
+      echo "partition on $threads threads ($(basename "$scenario")): FAILED"
+      status=1
+    fi
+  done
+done
+exit $status
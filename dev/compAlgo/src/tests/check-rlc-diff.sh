@@ -0,0 +1,15 @@
+#!/bin/bash
+# Checks rlc-diff on a small fixture: three CoMP members and a fourth cell at every start time,
+# the best member is kept at 0.001 and 0.003, a worse one at 0.002 which makes the only wrong range.
+# usage: check-rlc-diff.sh [rlc-diff binary]
+
+DIR=$(cd "$(dirname "$0")" && pwd)
+RLC_DIFF=${1:-$DIR/../../build/release/bin/rlc-diff}
+
+cd "$DIR/rlc-diff" || exit 1
+if "$RLC_DIFF" input.txt output.txt | diff -u expected.txt -; then
+  echo "rlc-diff: OK"
+else
+  echo "rlc-diff: FAILED"
+  exit 1
+fi
@@ -0,0 +1,33 @@
+#!/bin/bash
+# Checks that --sweep writes the same sweep.log on 1 thread and on 2 to 4 threads, for a grid of the kama and
+# wma algorithms whose indicators keep the most state. Runs on the scenario of ./input.
+# usage: check-sweep.sh [compAlgo binary]
+
+DIR=$(cd "$(dirname "$0")" && pwd)
+COMP_ALGO=$(readlink -f "${1:-$DIR/../../build/release/bin/compAlgo}")
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+cat > "$WORK/grid.txt" << EOF
+algoType naive wmaRaw smmRaw kamaRaw kamaPure hybrid
+kamaN 10 12
+EOF
+
+cd "$DIR/../.." || exit 1
+mkdir -p output
+rm -f output/sweep.log
+"$COMP_ALGO" --sweep "$WORK/grid.txt" 1 > /dev/null 2>&1 || { echo "sweep: the run on 1 thread failed"; exit 1; }
+mv output/sweep.log "$WORK/sequential.log"
+
+status=0
+for threads in 2 3 4; do
+  "$COMP_ALGO" --sweep "$WORK/grid.txt" $threads > /dev/null 2>&1 || { echo "sweep: the run on $threads threads failed"; exit 1; }
+  if diff -q "$WORK/sequential.log" output/sweep.log > /dev/null; then
+    echo "sweep on $threads threads: OK"
+  else
+    echo "sweep on $threads threads: FAILED"
+    diff "$WORK/sequential.log" output/sweep.log | head -n 10
+    status=1
+  fi
+done
+exit $status
@@ -0,0 +1,33 @@
+#!/bin/bash
+# Checks that the throughput compAlgo logs is the one throughput-calc gives for its output DlRlcStats.txt,
+# per UE and of all UEs together as with --ignore-imsi. Runs on the scenario of ./input.
+# usage: check-throughput.sh [bin directory with compAlgo and throughput-calc]
+
+DIR=$(cd "$(dirname "$0")" && pwd)
+BIN=$(readlink -f "${1:-$DIR/../../build/release/bin}")
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+cd "$DIR/../.." || exit 1
+mkdir -p output
+rm -f output/*
+"$BIN/compAlgo" > "$WORK/compAlgo.log" 2>&1 || { echo "throughput: the run failed"; exit 1; }
+
+# "<UE> <max> <average>" lines, the UE is the IMSI or "all"
+awk '/IMSI = / { print $4, $8, $6 } /all UEs/ { print "all", $7, $5 }' "$WORK/compAlgo.log" | sort > "$WORK/logged"
+{
+  "$BIN/throughput-calc" output/DlRlcStats.txt | awk '/^[0-9]/ && ($2 != 0 || $3 != 0) { print $1, $2, $3 }'
+  "$BIN/throughput-calc" output/DlRlcStats.txt --ignore-imsi | awk '/^1 / { print "all", $2, $3 }'
+} | sort > "$WORK/calculated"
+
+# the log has 6 significant digits
+if join "$WORK/logged" "$WORK/calculated" \
+    | awk 'function near(a, b) { d = a - b; return (d < 0 ? -d : d) <= 1e-5 * (b < 0 ? -b : b) }
+           { lines++ } !near($2, $4) || !near($3, $5) { print "UE " $1 ": logged " $2 " " $3 ", calculated " $4 " " $5; bad = 1 }
+           END { exit bad || !lines }' \
+   && [ "$(wc -l < "$WORK/logged")" -eq "$(wc -l < "$WORK/calculated")" ]; then
+  echo "throughput: OK"
+else
+  echo "throughput: FAILED"
+  exit 1
+fi
@@ -0,0 +1,112 @@
+#include "tests.h"
+
+#include <sstream>
+
+namespace
+{
+  struct Sample
+  {
+    Time time;
+    int cellId;
+  };
+
+  void roundTrip()
+  {
+    const std::string text = "compAlgo checkpoint";
+    const std::vector<Sample> samples {{1, 2}, {3, 4}};
+    const std::deque<int> cells {1, 2, 3};
+    std::queue<double> values;
+    values.push(0.5);
+    values.push(-1.5);
+    const std::map<int, std::string> names {{1, "one"}, {2, ""}};
+    const std::unordered_map<int, Time> times {{3, 30}, {4, 40}};
+
+    std::stringstream stream;
+    CheckpointWriter writer(stream);
+    writer.write(text);
+    writer.write(samples);
+    writer.write(cells);
+    writer.write(values);
+    writer.write(names);
+    writer.write(times);
+    writer.write(std::make_pair(7, 8.0));
+    CHECK(writer.good());
+
+    std::string textRead;
+    std::vector<Sample> samplesRead;
+    std::deque<int> cellsRead;
+    std::queue<double> valuesRead;
+    std::map<int, std::string> namesRead;
+    std::unordered_map<int, Time> timesRead;
+    std::pair<int, double> pairRead;
+    CheckpointReader reader(stream);
+    reader.read(textRead);
+    reader.read(samplesRead);
+    reader.read(cellsRead);
+    reader.read(valuesRead);
+    reader.read(namesRead);
+    reader.read(timesRead);
+    reader.read(pairRead);
+    CHECK(reader.good());
+
+    CHECK(textRead == text);
+    CHECK(samplesRead.size() == 2 && samplesRead[1].time == 3 && samplesRead[1].cellId == 4);
+    CHECK(cellsRead == cells);
+    CHECK(valuesRead.size() == 2 && valuesRead.front() == 0.5 && valuesRead.back() == -1.5);
+    CHECK(namesRead == names);
+    CHECK(timesRead == times);
+    CHECK(pairRead == std::make_pair(7, 8.0));
+
+    // nothing is left to read
+    char extra;
+    reader.read(extra);
+    CHECK(!reader.good());
+  }
+
+  void forgedSize()
+  {
+    std::stringstream stream;
+    CheckpointWriter writer(stream);
+    writer.write(std::vector<Sample> {{1, 2}});
+    std::string data = stream.str();
+    // one element more than is stored
+    data[0] = 2;
+
+    std::stringstream forged(data);
+    CheckpointReader reader(forged);
+    std::vector<Sample> samples;
+    reader.read(samples);
+    CHECK(!reader.good());
+    CHECK(samples.empty());
+
+    // a size no memory could hold
+    std::stringstream huge;
+    CheckpointWriter(huge).write(~size_t(0));
+    CheckpointReader hugeReader(huge);
+    std::string text;
+    hugeReader.read(text);
+    CHECK(!hugeReader.good());
+    CHECK(text.empty());
+  }
+
+  void truncated()
+  {
+    std::stringstream stream;
+    CheckpointWriter writer(stream);
+    writer.write(std::map<int, Time> {{1, 10}, {2, 20}});
+    const std::string data = stream.str();
+
+    std::stringstream cut(data.substr(0, data.size() - 1));
+    CheckpointReader reader(cut);
+    std::map<int, Time> values;
+    reader.read(values);
+    CHECK(!reader.good());
+  }
+}
+
+void Tests::checkpoint()
+{
+  roundTrip();
+  forgedSize();
+  truncated();
+}
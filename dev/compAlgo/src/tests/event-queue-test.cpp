@@ -0,0 +1,80 @@
+#include "tests.h"
+
+#include <random>
+#include <limits>
+
+#include "../event-queue.h"
+
+namespace
+{
+  Event eventAt(Time time, CellId order)
+  {
+    Event event(EventType::x2Message, time);
+    event.cellId = order; //< push order to check the equal time events by
+    return event;
+  }
+
+  //! @brief the same pushes and pops on both queues, the pushes are never earlier than the last pop
+  //!  as in a simulation. The times go up to a level 3 delay of the wheel, with many equal ones.
+  void sameOrder()
+  {
+    std::mt19937 random(1);
+    std::uniform_int_distribution<int> action(0, 2);
+    std::uniform_int_distribution<Time> delay(0, Time(1) << 26);
+    std::uniform_int_distribution<Time> shortDelay(0, 3);
+
+    HeapEventQueue heap;
+    TimingWheelEventQueue wheel;
+    Time now = 0;
+    CellId pushesCount = 0;
+    CellId lastOrder = -1;
+    for (int i = 0; i < 200000; i++)
+      {
+        if (action(random) || heap.empty())
+          {
+            const Event event = eventAt(now + (i % 2 ? shortDelay(random) : delay(random)), pushesCount++);
+            heap.push(event);
+            wheel.push(event);
+            continue;
+          }
+
+        CHECK(heap.nextTime() == wheel.nextTime());
+        const Event fromHeap = heap.pop();
+        const Event fromWheel = wheel.pop();
+        CHECK(fromHeap.atTime == fromWheel.atTime);
+        CHECK(fromWheel.atTime >= now);
+        // equal time events leave the wheel in the push order
+        CHECK(fromWheel.atTime > now || lastOrder < fromWheel.cellId);
+        lastOrder = fromWheel.cellId;
+        now = fromWheel.atTime;
+        CHECK(heap.size() == wheel.size());
+      }
+
+    while (!heap.empty())
+      {
+        CHECK(!wheel.empty() && heap.pop().atTime == wheel.pop().atTime);
+      }
+    CHECK(wheel.empty());
+  }
+
+  void farFuture()
+  {
+    TimingWheelEventQueue wheel;
+    const Time far = std::numeric_limits<Time>::max() / 2;
+    wheel.push(eventAt(far, 0));
+    wheel.push(eventAt(5, 1));
+    wheel.push(eventAt(far, 2));
+    CHECK(wheel.nextTime() == 5);
+    CHECK(wheel.pop().cellId == 1);
+    CHECK(wheel.nextTime() == far);
+    CHECK(wheel.pop().cellId == 0);
+    CHECK(wheel.pop().cellId == 2);
+    CHECK(wheel.empty());
+  }
+}
+
+void Tests::eventQueues()
+{
+  sameOrder();
+  farFuture();
+}
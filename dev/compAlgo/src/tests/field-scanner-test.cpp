@@ -0,0 +1,85 @@
+#include "tests.h"
+
+#include <cstring>
+#include <cstdlib>
+#include <random>
+#include <limits>
+
+#include "../field-scanner.h"
+
+namespace
+{
+  FieldScanner scannerOf(const char *line)
+  {
+    return FieldScanner(line, line + strlen(line));
+  }
+
+  //! @brief the fast path and the strtod fallback both give what strtod does
+  void decimals()
+  {
+    const char *const fields[] = {
+      "0", "-0", "+7", "0.1", "0.2", "0.3", ".5", "5.", "-1.25", "3.14159265358979",
+      "1e-5", "2.5E3", "1e22", "1e23", "9007199254740993", "123456789012345678901234",
+      "0.000123456789012345678", "4.9e-324", "1.7976931348623157e308", "1e400", "-2.2250738585072014e-308"
+    };
+    for (const char *field : fields)
+      {
+        double value = -1;
+        CHECK(scannerOf(field).next(value) && value == strtod(field, nullptr));
+      }
+
+    std::mt19937 random(1);
+    std::uniform_int_distribution<uint64_t> mantissa(0, uint64_t(1) << 60);
+    std::uniform_int_distribution<int> fraction(0, 25);
+    for (int i = 0; i < 100000; i++)
+      {
+        std::string field = std::to_string(mantissa(random));
+        const size_t point = fraction(random);
+        if (point < field.size())
+          field.insert(field.size() - point, ".");
+        double value = -1;
+        CHECK(scannerOf(field.c_str()).next(value) && value == strtod(field.c_str(), nullptr));
+      }
+  }
+
+  void line()
+  {
+    FieldScanner scanner = scannerOf("0.001\t0.002 \t 3\t-4\t18446744073709551615\r");
+    double start = 0, end = 0;
+    int cellId = 0, offset = 0;
+    uint64_t index = 0;
+    CHECK(scanner.next(start) && start == 0.001);
+    CHECK(scanner.next(end) && end == 0.002);
+    CHECK(scanner.next(cellId) && cellId == 3);
+    CHECK(scanner.next(offset) && offset == -4);
+    CHECK(scanner.next(index) && index == std::numeric_limits<uint64_t>::max());
+    // the line is over
+    CHECK(!scanner.next(cellId));
+  }
+
+  void malformed()
+  {
+    int value = 0;
+    double decimal = 0;
+    uint64_t count = 0;
+    CHECK(!scannerOf("abc").next(decimal));
+    CHECK(!scannerOf("-").next(decimal));
+    CHECK(!scannerOf("1e").next(decimal));
+    CHECK(!scannerOf("2147483648").next(value));
+    CHECK(!scannerOf("18446744073709551616").next(count));
+    CHECK(!scannerOf("-1").next(count));
+
+    // a malformed field fails every next call, the later fields are not read
+    FieldScanner scanner = scannerOf("1 x 2");
+    CHECK(scanner.next(value) && value == 1);
+    CHECK(!scanner.next(value));
+    CHECK(!scanner.next(value));
+  }
+}
+
+void Tests::fieldScanner()
+{
+  decimals();
+  line();
+  malformed();
+}
@@ -0,0 +1,32 @@
+#include "tests.h"
+
+namespace
+{
+  size_t failuresCount = 0;
+}
+
+void Tests::fail(const char *file, int line, const char *check)
+{
+  ++failuresCount;
+  std::cerr << file << ":" << line << "\tFAIL: " << check << "\n";
+}
+
+//! @brief unit tests of the simulation modules, run after a build with every change
+//! @return 1 if a check has failed
+int main()
+{
+  const std::pair<const char*, void (*)()> tests[] = {
+    {"checkpoint", Tests::checkpoint}
+    , {"event queues", Tests::eventQueues}
+    , {"field scanner", Tests::fieldScanner}
+  };
+
+  for (const auto &test : tests)
+    {
+      const size_t failuresBefore = failuresCount;
+      test.second();
+      LOG(test.first << (failuresCount == failuresBefore ? ": OK" : ": FAILED"));
+    }
+  LOG((failuresCount ? "Problem detected" : "done"));
+  return failuresCount ? 1 : 0;
+}
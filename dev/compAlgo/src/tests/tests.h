@@ -0,0 +1,18 @@
+#pragma once
+
+#include "../helpers.h"
+
+//! @brief a failed check is counted and reported, the test goes on
+#define CHECK(x) if (!(x)) { Tests::fail(__FILE__, __LINE__, #x); }
+
+namespace Tests
+{
+  void fail(const char *file, int line, const char *check);
+
+  //! @brief round trip of the simulation state containers and rejection of the broken checkpoints
+  void checkpoint();
+  //! @brief TimingWheelEventQueue pops the events in the time order of HeapEventQueue, equal times in the push order
+  void eventQueues();
+  //! @brief FieldScanner reads the numbers as strtod and strtol do and fails on the malformed fields
+  void fieldScanner();
+}
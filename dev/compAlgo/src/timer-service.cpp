@@ -0,0 +1,43 @@
+#include "timer-service.h"
+
+#include "sim-context.h"
+
+TimerService::TimerService(SimContext &context)
+  : mContext(context)
+  , mTimers(context.arena())
+{
+}
+
+TimerHandle TimerService::schedule(CellId target, Time atTime)
+{
+  size_t &count = mTimers[std::make_pair(target, atTime)];
+  if (!count++)
+    {
+      Event event { EventType::l2Timeout, atTime };
+      event.cellId = target;
+      mContext.scheduleEvent(event);
+    }
+
+  TimerHandle handle;
+  handle.target = target;
+  handle.atTime = atTime;
+  handle.isValid = true;
+  return handle;
+}
+
+void TimerService::cancel(TimerHandle &handle)
+{
+  if (!handle.isValid)
+    return;
+  handle.isValid = false;
+
+  auto timer = mTimers.find(std::make_pair(handle.target, handle.atTime));
+  assert(timer != mTimers.end());
+  if (!--timer->second)
+    mTimers.erase(timer);
+}
+
+bool TimerService::expire(CellId target, Time atTime)
+{
+  return mTimers.erase(std::make_pair(target, atTime)) > 0;
+}
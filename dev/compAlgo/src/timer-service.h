@@ -0,0 +1,44 @@
+#pragma once
+
+#include <map>
+
+#include "helpers.h"
+#include "memory-arena.h"
+
+class SimContext;
+
+//! @brief identifies one timer of TimerService, invalid after cancel
+struct TimerHandle
+{
+  CellId target = -1;
+  Time atTime = 0;
+  bool isValid = false;
+};
+
+//! @class TimerService wakes the cells up at the requested time by EventType::l2Timeout
+//! @brief timers of one target and time are coalesced to one event. The event stays in the queue
+//!  after all its timers are cancelled, then expire() tells it is stale and the target is not woken.
+class TimerService
+{
+public:
+  TimerService(SimContext &context);
+
+  TimerHandle schedule(CellId target, Time atTime);
+  //! @note the handle must be cancelled before its time
+  void cancel(TimerHandle &handle);
+
+  //! @return true if the target has timers at the time, they are consumed
+  bool expire(CellId target, Time atTime);
+
+  void saveState(CheckpointWriter &writer) const { writer.write(mTimers); }
+  void loadState(CheckpointReader &reader) { reader.read(mTimers); }
+
+private:
+  SimContext &mContext;
+  using TimerKey = std::pair<CellId, Time>;
+  //! @brief pending timers count per target and time
+  std::map<TimerKey, size_t, std::less<TimerKey>, ArenaAllocator<std::pair<const TimerKey, size_t>>> mTimers;
+
+  TimerService(const TimerService &) = delete;
+  TimerService& operator =(const TimerService &) = delete;
+};
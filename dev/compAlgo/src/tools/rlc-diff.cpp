@@ -0,0 +1,272 @@
+#include <cstring>
+#include <cstdio>
+#include <cmath>
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include "../helpers.h"
+#include "../field-scanner.h"
+#include "../line-reader.h"
+
+namespace
+{
+  const char *const linesOption = "--lines";
+  const double timeEps = 0.0001; //< [s] as in diffRlc.py
+  const int compMembersCount = 3;  //< the cells L2Mac can choose the direct one of
+
+  //! @brief the columns of DlRlcStats.txt the diff needs
+  struct RlcLine
+  {
+    double start;
+    double end;
+    int cellId;
+    double rxBytes;
+  };
+
+  bool parse(const char *begin, const char *end, RlcLine &line)
+  {
+    // start end CellId IMSI RNTI LCID nTxPDUs TxBytes nRxPDUs RxBytes ...
+    double fields[10];
+    FieldScanner scanner(begin, end);
+    for (double &field : fields)
+      if (!scanner.next(field))
+        return false;
+
+    line = {fields[0], fields[1], static_cast<int>(fields[2]), fields[9]};
+    return true;
+  }
+
+  std::string timeText(double time)
+  {
+    char text[32];
+    snprintf(text, sizeof(text), "%.4f", time);
+    return text;
+  }
+
+  //! @class RlcDiff walks the input RLC trace and the output of a run together: the output is the
+  //!  subsequence of the input lines of the transmitted packets, so every input line is either kept or dropped
+  //! @brief a subframe is the group of the input lines of one start time, of all the cells and UEs.
+  //!  The direct cell is wrong in a subframe if the kept lines carry less than the best line of the CoMP
+  //!  members 1..compMembersCount could. Only one subframe and one open range of the wrong subframes are held,
+  //!  the memory does not grow with the traces.
+  class RlcDiff
+  {
+  public:
+    explicit RlcDiff(bool printLines) : mPrintLines(printLines) {}
+
+    void addInput(const char *begin, const char *end, const RlcLine &line, bool isKept);
+    //! @brief the output line does not match any input line
+    void addUnmatched(const char *begin, const char *end);
+    void finish();
+
+    bool hasUnmatched() const { return mUnmatchedCount; }
+    void write(std::ostream &stream) const;
+
+  private:
+    struct CellCounts
+    {
+      uint64_t kept = 0;
+      uint64_t dropped = 0;
+    };
+    struct Subframe
+    {
+      double start = NAN;
+      double end = NAN;
+      double bestRxBytes = 0;
+      double keptRxBytes = 0;
+    };
+    struct WrongRange
+    {
+      double start;
+      double end;
+      uint64_t subframes;
+    };
+
+    const bool mPrintLines;
+    std::map<int, CellCounts> mCells; //< by cell ID
+    Subframe mSubframe;
+    bool mHasOpenRange = false;
+    WrongRange mOpenRange {};
+    uint64_t mUnmatchedCount = 0;
+    uint64_t mWrongSubframesCount = 0;
+    uint64_t mWrongRangesCount = 0;
+
+    RlcDiff(const RlcDiff &) = delete;
+    RlcDiff& operator =(const RlcDiff &) = delete;
+
+    void closeSubframe();
+    void closeRange();
+  };
+
+  void RlcDiff::addInput(const char *begin, const char *end, const RlcLine &line, bool isKept)
+  {
+    if (mPrintLines)
+      std::cout << (isKept ? "+\t" : "-\t") << std::string(begin, end) << "\n";
+
+    CellCounts &counts = mCells[line.cellId];
+    ++(isKept ? counts.kept : counts.dropped);
+
+    if (std::isnan(mSubframe.start) || std::abs(line.start - mSubframe.start) > timeEps)
+      {
+        closeSubframe();
+        mSubframe.start = line.start;
+        mSubframe.end = line.end;
+      }
+    if (line.cellId <= compMembersCount)
+      mSubframe.bestRxBytes = std::max(mSubframe.bestRxBytes, line.rxBytes);
+    if (isKept)
+      mSubframe.keptRxBytes = std::max(mSubframe.keptRxBytes, line.rxBytes);
+  }
+
+  void RlcDiff::addUnmatched(const char *begin, const char *end)
+  {
+    if (!mUnmatchedCount++)
+      {
+        WARN("the output line is not in the input: " << std::string(begin, end));
+      }
+    if (mPrintLines)
+      std::cout << "?\t" << std::string(begin, end) << "\n";
+  }
+
+  void RlcDiff::finish()
+  {
+    closeSubframe();
+    if (mHasOpenRange)
+      closeRange();
+  }
+
+  void RlcDiff::closeSubframe()
+  {
+    if (std::isnan(mSubframe.start))
+      return;
+
+    if (mSubframe.keptRxBytes < mSubframe.bestRxBytes)
+      {
+        ++mWrongSubframesCount;
+        if (!mHasOpenRange)
+          {
+            mOpenRange = {mSubframe.start, mSubframe.end, 1};
+            mHasOpenRange = true;
+          }
+        else
+          {
+            mOpenRange.end = mSubframe.end;
+            ++mOpenRange.subframes;
+          }
+      }
+    else if (mHasOpenRange)
+      closeRange();
+    mSubframe = Subframe();
+  }
+
+  void RlcDiff::closeRange()
+  {
+    ++mWrongRangesCount;
+    std::cout << "!\t" << timeText(mOpenRange.start) << "\t" << timeText(mOpenRange.end)
+              << "\t" << mOpenRange.subframes << " subframes\n";
+    mHasOpenRange = false;
+  }
+
+  void RlcDiff::write(std::ostream &stream) const
+  {
+    CellCounts total;
+    stream << "\nCell\tKept\tDropped\n";
+    for (const auto &cell : mCells)
+      {
+        stream << cell.first << "\t" << cell.second.kept << "\t" << cell.second.dropped << "\n";
+        total.kept += cell.second.kept;
+        total.dropped += cell.second.dropped;
+      }
+    stream << "all\t" << total.kept << "\t" << total.dropped << "\n\n";
+    stream << "Wrong direct cell:\t" << mWrongSubframesCount << " subframes in " << mWrongRangesCount << " ranges\n";
+    stream << "Output lines not in the input:\t" << mUnmatchedCount << "\n";
+  }
+
+  void usage()
+  {
+    std::cout << "Usage:  rlc-diff [input DlRlcStats.txt] [output DlRlcStats.txt] [" << linesOption << "]\n\n"
+              << linesOption << ":\tPrint every input line, '+' kept, '-' dropped, '?' output line not in the input\n"
+              << "The time ranges where the direct cell was wrong are printed with '!' as they end.\n"
+              << "The files may be gzip-compressed, they are streamed in constant memory.\n";
+  }
+}
+
+//! @brief native diffRlc.py: merges the input RLC trace with the output of a run in one pass
+//! @return 1 if the output has lines which are not in the input
+int main(int argc, char *argv[])
+{
+  std::vector<std::string> locations;
+  bool printLines = false;
+  for (int i = 1; i < argc; i++)
+    {
+      if (!strcmp(argv[i], linesOption))
+        printLines = true;
+      else if (argv[i][0] == '-')
+        {
+          usage();
+          return 1;
+        }
+      else
+        locations.push_back(argv[i]);
+    }
+  const std::string inputLocation = locations.size() > 0 ? locations[0]
+                                                         : "./input/" + std::to_string(SimConfig::traceInterval) + "/DlRlcStats.txt";
+  const std::string outputLocation = locations.size() > 1 ? locations[1] : "./output/DlRlcStats.txt";
+
+  LineReader input(inputLocation);
+  LineReader output(outputLocation);
+  if (!input.isOpen() || !output.isOpen())
+    {
+      ERR("cannot read " << (input.isOpen() ? outputLocation : inputLocation));
+    }
+
+  RlcDiff diff(printLines);
+  const char *outBegin = nullptr, *outEnd = nullptr;
+  RlcLine outLine {};
+  auto nextOutput = [&]()
+  {
+    while (output.next(outBegin, outEnd))
+      {
+        if (parse(outBegin, outEnd, outLine))
+          return true;
+        WARN("drop output line: " << std::string(outBegin, outEnd));
+      }
+    outBegin = outEnd = nullptr;
+    return false;
+  };
+  bool hasOutput = nextOutput();
+
+  const char *begin = nullptr, *end = nullptr;
+  RlcLine line {};
+  while (input.next(begin, end))
+    {
+      if (!parse(begin, end, line))
+        {
+          WARN("drop input line: " << std::string(begin, end));
+          continue;
+        }
+      // an output line earlier than the input is not one of its lines
+      while (hasOutput && outLine.start < line.start - timeEps)
+        {
+          diff.addUnmatched(outBegin, outEnd);
+          hasOutput = nextOutput();
+        }
+
+      const bool isKept = hasOutput && end - begin == outEnd - outBegin && std::equal(begin, end, outBegin);
+      diff.addInput(begin, end, line, isKept);
+      if (isKept)
+        hasOutput = nextOutput();
+    }
+  for (; hasOutput; hasOutput = nextOutput())
+    diff.addUnmatched(outBegin, outEnd);
+  diff.finish();
+
+  if (input.isBroken() || output.isBroken())
+    {
+      WARN("a file is broken, the diff is partial");
+    }
+  diff.write(std::cout);
+  std::cout << (diff.hasUnmatched() ? "Problem detected" : "done") << "\n";
+  return diff.hasUnmatched() ? 1 : 0;
+}
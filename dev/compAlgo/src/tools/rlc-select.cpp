@@ -0,0 +1,31 @@
+#include <fstream>
+
+#include "../packet-selection.h"
+#include "../helpers.h"
+
+//! usage: rlc-select [selection] [trace] [output]
+//! @brief writes the DlRlcStats.txt output of a run in SimConfig::rlcSelectionOutput mode
+//!  from its packet selection and the RLC trace of the scenario
+int main(int argc, char *argv[])
+{
+  const std::string selectionLocation = argc > 1 ? argv[1] : "./output/DlRlcStats.sel";
+  const std::string traceLocation = argc > 2 ? argv[2]
+                                             : "./input/" + std::to_string(SimConfig::traceInterval) + "/DlRlcStats.txt";
+  const std::string outputLocation = argc > 3 ? argv[3] : "./output/DlRlcStats.txt";
+
+  PacketSelection selection;
+  if (!selection.load(selectionLocation))
+    {
+      ERR("cannot read " << selectionLocation);
+    }
+
+  const RlcLineTable lines(traceLocation);
+  std::ofstream output(outputLocation, std::ios_base::out | std::ios_base::trunc);
+  selection.materialize(lines, output);
+  output.flush();
+  if (!output.good())
+    {
+      ERR("cannot write " << outputLocation);
+    }
+  return 0;
+}
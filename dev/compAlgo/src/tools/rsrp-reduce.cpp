@@ -0,0 +1,336 @@
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <vector>
+
+#include "../helpers.h"
+#include "../field-scanner.h"
+#include "../line-reader.h"
+
+namespace
+{
+  const char *const outliersOption = "--rm-outliers";
+  const char *const sameCellOption = "--same-cell";
+  const char *const widthOption = "--width";
+  const char *const smoothOption = "--smooth";
+  const char *const rangeOption = "--range";
+  const size_t defaultWidth = 2000; //< [px]
+  const size_t chunkSize = 5;
+  const size_t chunkOffset = 3;     //< of the neighbour chunk the deviation is averaged with
+  const double outlierFactor = 2.5;
+
+  //! @brief one curve of plotRsrp.py, times in seconds
+  struct Series
+  {
+    std::vector<double> times;
+    std::vector<double> values;
+  };
+
+  //! @brief numpy.median of up to chunkSize values
+  double median(const double *values, size_t count)
+  {
+    // insertion sort, the chunks are too short for anything else
+    double sorted[chunkSize];
+    for (size_t i = 0; i < count; i++)
+      {
+        size_t j = i;
+        for (; j > 0 && sorted[j - 1] > values[i]; j--)
+          sorted[j] = sorted[j - 1];
+        sorted[j] = values[i];
+      }
+    return count % 2 ? sorted[count / 2] : (sorted[count / 2 - 1] + sorted[count / 2]) / 2.0;
+  }
+
+  //! @brief median absolute deviation of the values, the deviations are left in the array
+  double medianDeviation(const double *values, size_t count, double *deviations)
+  {
+    const double center = median(values, count);
+    for (size_t i = 0; i < count; i++)
+      deviations[i] = std::abs(values[i] - center);
+    return median(deviations, count);
+  }
+
+  //! @brief reject_outliers_at of plotRsrp.py: drops the chunk values which deviate from its median more than
+  //!  outlierFactor times the median deviation, the deviation is averaged with the one of the chunk shifted by chunkOffset
+  //! @return end of the kept values, they are moved to the begin of the chunk
+  size_t rejectOutliersAt(Series &series, size_t begin, size_t end, size_t keptEnd)
+  {
+    const double *values = series.values.data();
+    const size_t count = end - begin;
+    double deviations[chunkSize];
+    double shiftedDeviations[chunkSize];
+    double deviation = medianDeviation(values + begin, count, deviations);
+    if (series.values.size() > end + chunkOffset)
+      deviation = (deviation + medianDeviation(values + begin + chunkOffset, count, shiftedDeviations)) / 2.0;
+
+    for (size_t i = 0; i < count; i++)
+      {
+        const double score = deviation ? deviations[i] / deviation : deviations[i];
+        if (score < outlierFactor)
+          {
+            series.times[keptEnd] = series.times[begin + i];
+            series.values[keptEnd] = series.values[begin + i];
+            ++keptEnd;
+          }
+      }
+    return keptEnd;
+  }
+
+  //! @brief reject_outliers of plotRsrp.py in place, chunk by chunk
+  //! @note the kept values are written behind the chunks being read, the shifted chunk is read before
+  //!  it is overwritten: the kept values of a chunk never pass its own begin
+  void rejectOutliers(Series &series)
+  {
+    const size_t size = series.values.size();
+    size_t keptEnd = 0;
+    for (size_t begin = 0; begin < size; begin += chunkSize)
+      keptEnd = rejectOutliersAt(series, begin, std::min(begin + chunkSize, size), keptEnd);
+    series.times.resize(keptEnd);
+    series.values.resize(keptEnd);
+  }
+
+  //! @brief smooth of plotRsrp.py: numpy.convolve with a 3-value box in the 'same' mode,
+  //!  the values beyond the ends count as zeros
+  void smooth(Series &series)
+  {
+    std::vector<double> &values = series.values;
+    double previous = 0;
+    for (size_t i = 0; i < values.size(); i++)
+      {
+        const double current = values[i];
+        const double next = i + 1 < values.size() ? values[i + 1] : 0;
+        values[i] = (previous + current + next) / 3;
+        previous = current;
+      }
+  }
+
+  //! @brief drops the values out of [fromTime, toTime] but the nearest one at each side,
+  //!  so the drawn line still reaches the borders of the plot
+  void cut(Series &series, double fromTime, double toTime)
+  {
+    const auto &times = series.times;
+    size_t begin = std::lower_bound(times.begin(), times.end(), fromTime) - times.begin();
+    size_t end = std::upper_bound(times.begin(), times.end(), toTime) - times.begin();
+    if (begin > 0)
+      --begin;
+    if (end < times.size())
+      ++end;
+    if (begin >= end)
+      {
+        series = Series();
+        return;
+      }
+    series.times.erase(series.times.begin() + end, series.times.end());
+    series.times.erase(series.times.begin(), series.times.begin() + begin);
+    series.values.erase(series.values.begin() + end, series.values.end());
+    series.values.erase(series.values.begin(), series.values.begin() + begin);
+  }
+
+  //! @brief keeps the first, the last, the minimum and the maximum value of every pixel column of
+  //!  [fromTime, toTime], so the drawn line is the same as the one of all the values.
+  //!  The values out of the range fall into the border columns.
+  void downsample(Series &series, double fromTime, double toTime, size_t width)
+  {
+    const size_t size = series.values.size();
+    if (!width || size <= 4 * width)
+      return;
+
+    const double *times = series.times.data();
+    const double *values = series.values.data();
+    const double pixelsPerSecond = toTime > fromTime ? width / (toTime - fromTime) : 0;
+    auto pixelOf = [&] (double time)
+      {
+        return static_cast<size_t>(std::min(std::max((time - fromTime) * pixelsPerSecond, 0.0), double(width - 1)));
+      };
+    std::vector<size_t> kept;
+    kept.reserve(4 * width);
+    for (size_t begin = 0, end = 0; begin < size; begin = end)
+      {
+        const size_t pixel = pixelOf(times[begin]);
+        end = begin + 1;
+        while (end < size && pixelOf(times[end]) == pixel)
+          ++end;
+
+        const size_t minimum = std::min_element(values + begin, values + end) - values;
+        const size_t maximum = std::max_element(values + begin, values + end) - values;
+        kept.push_back(begin);
+        kept.push_back(std::min(minimum, maximum));
+        kept.push_back(std::max(minimum, maximum));
+        kept.push_back(end - 1);
+      }
+    kept.erase(std::unique(kept.begin(), kept.end()), kept.end());
+
+    Series reduced;
+    reduced.times.reserve(kept.size());
+    reduced.values.reserve(kept.size());
+    for (size_t i : kept)
+      {
+        reduced.times.push_back(times[i]);
+        reduced.values.push_back(values[i]);
+      }
+    std::swap(series, reduced);
+  }
+
+  //! @brief load_measurements of plotRsrp.py: a series per target cell, with sameCell only the measurements
+  //!  of the serving cell as the series of the cell 1
+  //! @return false if the file cannot be read
+  bool load(const std::string &location, bool sameCell, std::map<int, Series> &series)
+  {
+    LineReader reader(location);
+    if (!reader.isOpen())
+      return false;
+
+    // time[usec] srcCellId targetCellId RSRP
+    const char *begin = nullptr, *end = nullptr;
+    while (reader.next(begin, end))
+      {
+        double time = 0, value = 0;
+        int sourceCellId = 0, targetCellId = 0;
+        FieldScanner scanner(begin, end);
+        if (!scanner.next(time) || !scanner.next(sourceCellId) || !scanner.next(targetCellId) || !scanner.next(value))
+          {
+            WARN("drop line: " << std::string(begin, end));
+            continue;
+          }
+        if (sameCell && sourceCellId != targetCellId)
+          continue;
+
+        Series &cell = series[sameCell ? 1 : targetCellId];
+        cell.times.push_back(time / 1000 / 1000);
+        cell.values.push_back(value);
+      }
+    if (reader.isBroken())
+      {
+        WARN(location << " is broken, the series are partial");
+      }
+    return true;
+  }
+
+  bool save(const std::string &location, const std::map<int, Series> &series)
+  {
+    std::ofstream file(location, std::ios_base::out | std::ios_base::trunc);
+    file << "% series\ttime[s]\tRSRP\n";
+    char line[96];
+    for (const auto &cell : series)
+      for (size_t i = 0; i < cell.second.times.size(); i++)
+        {
+          snprintf(line, sizeof(line), "%d\t%.6f\t%.12g\n", cell.first, cell.second.times[i], cell.second.values[i]);
+          file << line;
+        }
+    file.flush();
+    return file.good();
+  }
+
+  void usage()
+  {
+    std::cout << "Usage:  rsrp-reduce measurements.log [series] [" << outliersOption << "] [" << smoothOption
+              << "] [" << sameCellOption << "]\n"
+              << "                    [" << widthOption << " pixels] [" << rangeOption << " <from [s]> <to [s]>]\n\n"
+              << "Writes the curves of plotRsrp.py to the series file, '<measurements.log>.series' by default:\n"
+              << "a line per point of \"series time[s] RSRP\", a series per target cell.\n"
+              << outliersOption << ":\tReject the outliers of 5-value chunks of the series 1-3 as plotRsrp.py does\n"
+              << smoothOption << ":\tSmooth the series 1-3 with a 3-value box as plotRsrp.py does, after "
+              << outliersOption << "\n"
+              << sameCellOption << ":\tOnly the measurements of the serving cell, as the series 1\n"
+              << widthOption << ":\tKeep the minimum and the maximum of every pixel column of the plot, "
+              << defaultWidth << " by default, 0 keeps all the points\n"
+              << rangeOption << ":\tThe time range of the plot, the whole series by default. Only the points of the "
+              << "range and\n\tone beyond each of its ends are kept, the pixel columns span the range\n"
+              << "The measurements may be gzip-compressed.\n";
+  }
+}
+
+//! @brief native reduction of the measurements for plotRsrp.py: the outliers are rejected and the series
+//!  are downsampled to the plot width, so the plotter draws thousands of points instead of the whole trace.
+//!  A zoomed view of the plot is reduced with its own --range, the points of a whole-trace reduction are too sparse for it.
+int main(int argc, char *argv[])
+{
+  std::vector<std::string> locations;
+  bool mayRejectOutliers = false;
+  bool maySmooth = false;
+  bool sameCell = false;
+  bool hasRange = false;
+  double fromTime = INFINITY, toTime = -INFINITY;
+  size_t width = defaultWidth;
+  for (int i = 1; i < argc; i++)
+    {
+      if (!strcmp(argv[i], outliersOption))
+        mayRejectOutliers = true;
+      else if (!strcmp(argv[i], smoothOption))
+        maySmooth = true;
+      else if (!strcmp(argv[i], sameCellOption))
+        sameCell = true;
+      else if (!strcmp(argv[i], widthOption) && i + 1 < argc)
+        width = strtoul(argv[++i], nullptr, 10);
+      else if (!strcmp(argv[i], rangeOption) && i + 2 < argc)
+        {
+          char *fromEnd = nullptr, *toEnd = nullptr;
+          fromTime = strtod(argv[++i], &fromEnd);
+          toTime = strtod(argv[++i], &toEnd);
+          hasRange = true;
+          if (*fromEnd || *toEnd || fromEnd == argv[i - 1] || toEnd == argv[i] || !(fromTime < toTime))
+            {
+              usage();
+              return 1;
+            }
+        }
+      else if (argv[i][0] == '-')
+        {
+          usage();
+          return 1;
+        }
+      else
+        locations.push_back(argv[i]);
+    }
+  if (locations.empty())
+    {
+      usage();
+      return 1;
+    }
+  const std::string seriesLocation = locations.size() > 1 ? locations[1] : locations[0] + ".series";
+
+  std::map<int, Series> series;
+  if (!load(locations[0], sameCell, series))
+    {
+      ERR("cannot read " << locations[0]);
+    }
+
+  // plotRsrp.py rejects the outliers of the cells only, the series 11-13 are drawn as they are
+  if (mayRejectOutliers)
+    for (auto &cell : series)
+      if (cell.first >= 1 && cell.first <= 3)
+        rejectOutliers(cell.second);
+  // before the cut, the box of a border point spans the values beyond the range
+  if (maySmooth)
+    for (auto &cell : series)
+      if (cell.first >= 1 && cell.first <= 3)
+        smooth(cell.second);
+
+  // the pixel columns are common to all the series as they share the axis
+  if (hasRange)
+    {
+      for (auto &cell : series)
+        cut(cell.second, fromTime, toTime);
+    }
+  else
+    {
+      for (const auto &cell : series)
+        if (!cell.second.times.empty())
+          {
+            fromTime = std::min(fromTime, cell.second.times.front());
+            toTime = std::max(toTime, cell.second.times.back());
+          }
+    }
+  for (auto &cell : series)
+    downsample(cell.second, fromTime, toTime, width);
+
+  if (!save(seriesLocation, series))
+    {
+      ERR("cannot write " << seriesLocation);
+    }
+  return 0;
+}
@@ -0,0 +1,264 @@
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <sstream>
+#include <iomanip>
+
+#include "../helpers.h"
+#include "../field-scanner.h"
+#include "../line-reader.h"
+
+namespace
+{
+  const char *const ignoreImsiOption = "--ignore-imsi";
+  const double epochDuration = .200; //< [s], the trace times are in seconds
+  const size_t uesCount = 3;
+
+  double toThroughputKbps(double bytes, double seconds)
+  {
+    return bytes / 1000.0 * 8 / seconds;
+  }
+
+  //! @brief str() of Python 2 the figures of throughputCalc.py are printed with
+  std::string pythonFloat(double value)
+  {
+    char text[32];
+    snprintf(text, sizeof(text), "%.12g", value);
+    std::string result(text);
+    if (std::isfinite(value) && result.find_first_of(".e") == std::string::npos)
+      result += ".0";
+    return result;
+  }
+
+  //! @brief round(value, 2) of Python 2, the halves go away from zero
+  double pythonRound2(double value)
+  {
+    char text[64];
+    // a binary fraction is a half of the hundredths only if it is an odd number of eighths
+    const double eighths = value * 8;
+    if (eighths == std::floor(eighths) && std::fmod(eighths, 2) != 0)
+      snprintf(text, sizeof(text), "%.2f", value + (value > 0 ? 0.005 : -0.005));
+    else
+      snprintf(text, sizeof(text), "%.2f", value);
+    return strtod(text, nullptr);
+  }
+
+  //! @brief every line of a text or gzip-compressed file as it is
+  //! @return false if the file cannot be read
+  bool readLines(const std::string &location, std::vector<std::string> &lines)
+  {
+    LineReader reader(location);
+    const char *begin = nullptr, *end = nullptr;
+    while (reader.nextLine(begin, end))
+      lines.emplace_back(begin, end);
+    return reader.isOpen() && !reader.isBroken();
+  }
+
+  //! @class RlcThroughput is processRlcStats of throughputCalc.py: the maximum throughput over
+  //!  the epochs and the average one per UE, or of all of them with --ignore-imsi
+  //! @note the arithmetic is the one of the script, so the figures are the same
+  class RlcThroughput
+  {
+  public:
+    RlcThroughput(double startTime, bool ignoreImsi) : mStartTime(startTime), mIgnoreImsi(ignoreImsi) {}
+
+    //! @arg begin, end the line of DlRlcStats.txt without the line break
+    void add(const char *begin, const char *end);
+
+    bool empty() const { return !mRowsCount; }
+    //! @return the average throughput of all UEs or zero if they are not summed up
+    double aggregateAverageKbps() const { return mIgnoreImsi ? averageKbps(0) : 0; }
+    double aggregateMaximumKbps() const { return mIgnoreImsi ? mMaxThroughput[0] : 0; }
+
+    void write(std::ostream &stream) const;
+
+  private:
+    const double mStartTime; //< NaN to take all the rows
+    const bool mIgnoreImsi;
+    uint64_t mRowsCount = 0;
+    double mFirstStartTime = 0;
+    double mLastEndTime = 0;
+    double mTotalBytesRx[uesCount] = {};
+    double mTotalBytesRxPrev[uesCount] = {};
+    double mMaxThroughput[uesCount] = {};
+    double mEpochStartTime[uesCount] = {};
+
+    double averageKbps(size_t ue) const
+    {
+      return toThroughputKbps(mTotalBytesRx[ue], mLastEndTime - mFirstStartTime);
+    }
+  };
+
+  void RlcThroughput::add(const char *begin, const char *end)
+  {
+    // comments and blank lines are skipped as numpy.loadtxt does
+    const char *comment = static_cast<const char*>(memchr(begin, '%', end - begin));
+    if (comment)
+      end = comment;
+    if (std::all_of(begin, end, [] (char ch) { return isspace(static_cast<unsigned char>(ch)); }))
+      return;
+
+    // start end CellId IMSI RNTI LCID nTxPDUs TxBytes nRxPDUs RxBytes ...
+    double fields[10];
+    FieldScanner scanner(begin, end);
+    for (double &field : fields)
+      if (!scanner.next(field))
+        {
+          WARN("drop line: " << std::string(begin, end));
+          return;
+        }
+    const double time = fields[0];
+    const size_t ue = mIgnoreImsi ? 0 : static_cast<uint32_t>(fields[3]) - 1;
+    if (ue >= uesCount)
+      {
+        WARN("drop line of unknown IMSI: " << std::string(begin, end));
+        return;
+      }
+
+    if (!mRowsCount++)
+      {
+        mFirstStartTime = time;
+        std::fill(std::begin(mEpochStartTime), std::end(mEpochStartTime), time);
+      }
+    mLastEndTime = fields[1];
+    if (time < mStartTime)
+      return;
+
+    mTotalBytesRx[ue] += fields[9];
+    if (time >= mEpochStartTime[ue] + epochDuration)
+      {
+        const double throughput = toThroughputKbps(mTotalBytesRx[ue] - mTotalBytesRxPrev[ue], time - mEpochStartTime[ue]);
+        mMaxThroughput[ue] = std::max(throughput, mMaxThroughput[ue]);
+        mEpochStartTime[ue] = time;
+        mTotalBytesRxPrev[ue] = mTotalBytesRx[ue];
+      }
+  }
+
+  void RlcThroughput::write(std::ostream &stream) const
+  {
+    stream << "DlThroughput (RLC) [Kbps]:\n";
+    stream << "Ue Id   Max (per " << pythonFloat(epochDuration) << " sec)   Average\n";
+    for (size_t ue = 0; ue < (mIgnoreImsi ? 1 : uesCount); ue++)
+      {
+        stream << std::left << std::setw(8) << ue + 1 << std::setw(20) << pythonFloat(mMaxThroughput[ue])
+               << std::setw(16) << pythonFloat(averageKbps(ue)) << "\n";
+      }
+    stream << "\n";
+  }
+
+  //! @brief the summary row of throughputCalc.py: the throughputs and the cell switches of log.log
+  void writeSummary(const std::string &logLocation, const RlcThroughput &throughput, std::ostream &stream)
+  {
+    std::vector<std::string> lines;
+    if (!readLines(logLocation, lines) && !readLines(logLocation + ".gz", lines))
+      {
+        WARN("cannot read " << logLocation);
+        return;
+      }
+    if (lines.size() < 2)
+      {
+        WARN(logLocation << " has no cell switch statistics");
+        return;
+      }
+
+    const double aveTimeBetweenSwitches = pythonRound2(strtod(lines[0].c_str(), nullptr));
+    const long switchesCount = strtol(lines[1].c_str(), nullptr, 10);
+    stream << pythonFloat(pythonRound2(throughput.aggregateAverageKbps())) << " \t"
+           << pythonFloat(pythonRound2(throughput.aggregateMaximumKbps())) << " \t"
+           << switchesCount << " \t" << pythonFloat(aveTimeBetweenSwitches) << "\n";
+  }
+
+  std::string processRlcStats(const std::string &location, double startTime, bool ignoreImsi)
+  {
+    std::ostringstream result;
+    RlcThroughput throughput(startTime, ignoreImsi);
+    LineReader reader(location);
+    const char *begin = nullptr, *end = nullptr;
+    while (reader.next(begin, end))
+      throughput.add(begin, end);
+    if (!reader.isOpen() || reader.isBroken())
+      {
+        WARN("cannot read " << location);
+        return result.str();
+      }
+    if (throughput.empty())
+      {
+        WARN(location << " has no packets");
+        return result.str();
+      }
+
+    throughput.write(result);
+    // log.log is written by the same run next to DlRlcStats.txt
+    if (throughput.aggregateAverageKbps() > 0.1)
+      {
+        const size_t slash = location.rfind('/');
+        writeSummary((slash == std::string::npos ? "." : location.substr(0, slash)) + "/log.log", throughput, result);
+      }
+    return result.str();
+  }
+
+  bool isNumber(const char *text)
+  {
+    char *end = nullptr;
+    strtod(text, &end);
+    return end != text && !*end;
+  }
+
+  void usage()
+  {
+    std::cout << "Usage:  throughput-calc DlRlcStats.txt... [start time in the same resolution as in the file] ["
+              << ignoreImsiOption << "]\n\n"
+              << ignoreImsiOption << ":\tSum statistics\n"
+              << "The files may be gzip-compressed, several ones are processed in parallel.\n";
+  }
+}
+
+//! @brief native throughputCalc.py for the RLC traces: one pass over each file, the files are processed
+//!  on all the hardware threads and the results are printed in the order of the arguments
+int main(int argc, char *argv[])
+{
+  std::vector<std::string> locations;
+  double startTime = NAN;
+  bool ignoreImsi = false;
+  for (int i = 1; i < argc; i++)
+    {
+      if (!strcmp(argv[i], ignoreImsiOption))
+        ignoreImsi = true;
+      else if (isNumber(argv[i]))
+        startTime = strtod(argv[i], nullptr);
+      else
+        locations.push_back(argv[i]);
+    }
+  if (locations.empty())
+    {
+      usage();
+      return 1;
+    }
+
+  std::vector<std::string> results(locations.size());
+  std::atomic<size_t> nextFile(0);
+  auto work = [&]()
+  {
+    for (size_t i = nextFile++; i < locations.size(); i = nextFile++)
+      results[i] = processRlcStats(locations[i], startTime, ignoreImsi);
+  };
+  const size_t threadsCount = std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1u), locations.size());
+  std::vector<std::thread> workers;
+  for (size_t i = 1; i < threadsCount; ++i)
+    workers.emplace_back(work);
+  work();
+  for (auto &worker : workers)
+    worker.join();
+
+  for (size_t i = 0; i < locations.size(); i++)
+    {
+      if (locations.size() > 1)
+        std::cout << locations[i] << ":\n";
+      std::cout << results[i];
+    }
+  return 0;
+}
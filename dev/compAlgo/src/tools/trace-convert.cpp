@@ -0,0 +1,130 @@
+#include <cstring>
+
+#include "../columnar-trace.h"
+
+namespace
+{
+  //! @brief calls the handler with every line of the text trace but the header one and its number
+  template <typename Handler>
+  void forEachLine(const MappedFile &trace, Handler handler)
+  {
+    const char *data = trace.data();
+    const char *end = data + trace.size();
+    const char *lineEnd = static_cast<const char*>(memchr(data, '\n', trace.size()));
+    uint64_t lineNumber = 0;
+    for (const char *begin = lineEnd ? lineEnd + 1 : end; begin < end; begin = lineEnd + 1)
+      {
+        lineEnd = static_cast<const char*>(memchr(begin, '\n', end - begin));
+        if (!lineEnd)
+          lineEnd = end;
+        handler(begin, lineEnd, lineNumber++);
+      }
+  }
+
+  TraceFingerprint fingerprintOf(const std::string &location)
+  {
+    TraceFingerprint fingerprint;
+    if (!TraceFingerprint::of(location, fingerprint))
+      {
+        ERR("cannot read " << location);
+      }
+    return fingerprint;
+  }
+
+  void convertRlcStats(const std::string &location)
+  {
+    MappedFile trace(location);
+    if (!trace.isOpen())
+      {
+        ERR("cannot open " << location);
+      }
+
+    std::vector<Time> startTimes, endTimes;
+    std::vector<int32_t> cellIds, imsis, rntis, txBytes, rxBytes;
+    std::vector<uint64_t> lineNumbers, lineOffsets;
+    std::vector<char> lines;
+    forEachLine(trace, [&](const char *begin, const char *end, uint64_t lineNumber)
+    {
+      RlcRecord record;
+      const LineParse result = RlcTraceCursor::parse(begin, end, record);
+      if (result == LineParse::broken)
+        RlcTraceCursor::warnBroken(begin, end);
+      if (result != LineParse::event)
+        return;
+      startTimes.push_back(record.startTime);
+      endTimes.push_back(record.endTime);
+      cellIds.push_back(record.cellId);
+      imsis.push_back(record.imsi);
+      rntis.push_back(record.rnti);
+      txBytes.push_back(record.txBytes);
+      rxBytes.push_back(record.rxBytes);
+      lineNumbers.push_back(lineNumber);
+      lineOffsets.push_back(lines.size());
+      lines.insert(lines.end(), begin, end);
+      lines.push_back('\0');
+    });
+
+    ColumnarTraceWriter writer(TraceKind::rlcStats, fingerprintOf(location), startTimes.size());
+    writer.addColumn(startTimes);
+    writer.addColumn(endTimes);
+    writer.addColumn(cellIds);
+    writer.addColumn(imsis);
+    writer.addColumn(rntis);
+    writer.addColumn(txBytes);
+    writer.addColumn(rxBytes);
+    writer.addColumn(lineNumbers);
+    writer.addColumn(lineOffsets);
+    writer.addColumn(lines);
+    if (!writer.save(ColumnarTrace::locationOf(location)))
+      {
+        ERR("cannot write " << ColumnarTrace::locationOf(location));
+      }
+    LOG(location << ": " << startTimes.size() << " rows");
+  }
+
+  void convertMeasurements(const std::string &location)
+  {
+    MappedFile trace(location);
+    if (!trace.isOpen())
+      {
+        ERR("cannot open " << location);
+      }
+
+    std::vector<Time> times;
+    std::vector<int32_t> sourceCellIds, targetCellIds, rsrps;
+    forEachLine(trace, [&](const char *begin, const char *end, uint64_t)
+    {
+      MeasurementRecord record;
+      const LineParse result = MeasurementsTraceCursor::parse(begin, end, record);
+      if (result == LineParse::broken)
+        MeasurementsTraceCursor::warnBroken(begin, end);
+      if (result != LineParse::event)
+        return;
+      times.push_back(record.time);
+      sourceCellIds.push_back(record.sourceCellId);
+      targetCellIds.push_back(record.targetCellId);
+      rsrps.push_back(record.rsrp);
+    });
+
+    ColumnarTraceWriter writer(TraceKind::measurements, fingerprintOf(location), times.size());
+    writer.addColumn(times);
+    writer.addColumn(sourceCellIds);
+    writer.addColumn(targetCellIds);
+    writer.addColumn(rsrps);
+    if (!writer.save(ColumnarTrace::locationOf(location)))
+      {
+        ERR("cannot write " << ColumnarTrace::locationOf(location));
+      }
+    LOG(location << ": " << times.size() << " rows");
+  }
+}
+
+//! usage: trace-convert [input dir]
+//! @brief writes the columnar copies of the scenario traces next to them, compAlgo reads them instead of the text
+int main(int argc, char *argv[])
+{
+  const std::string inputDir = argc > 1 ? argv[1] : "./input/" + std::to_string(SimConfig::traceInterval);
+  convertRlcStats(inputDir + "/DlRlcStats.txt");
+  convertMeasurements(inputDir + "/measurements.log");
+  return 0;
+}
@@ -0,0 +1,9 @@
+#include "trace-buffer.h"
+
+TraceBuffer::TraceBuffer(ITraceCursor &source, RlcLinesPtr rlcLines)
+  : mRlcLines(rlcLines)
+{
+  for (; !source.empty(); source.pop())
+    mEvents.push_back(source.front());
+  mEvents.shrink_to_fit();
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "trace-cursor.h"
+#include "rlc-line-table.h"
+
+//! @class TraceBuffer is a fully parsed trace in time order, immutable once built
+//! @brief one buffer may feed any number of simulations, also from different threads
+class TraceBuffer
+{
+public:
+  //! @brief drains the source
+  //! @arg rlcLines of the trace for the text RLC output, not needed if the simulations have no outputs
+  explicit TraceBuffer(ITraceCursor &source, RlcLinesPtr rlcLines = nullptr);
+
+  size_t size() const { return mEvents.size(); }
+  const Event& operator [](size_t index) const { return mEvents[index]; }
+  const RlcLinesPtr& rlcLines() const { return mRlcLines; }
+
+private:
+  std::vector<Event> mEvents;
+  RlcLinesPtr mRlcLines;
+
+  TraceBuffer(const TraceBuffer &) = delete;
+  TraceBuffer& operator =(const TraceBuffer &) = delete;
+};
+
+using TraceBufferPtr = std::shared_ptr<const TraceBuffer>;
+
+
+//! @class TraceBufferCursor reads a shared TraceBuffer
+class TraceBufferCursor : public ITraceCursor
+{
+public:
+  TraceBufferCursor(TraceBufferPtr buffer) : mBuffer(buffer) {}
+
+  bool empty() override { return mPosition == mBuffer->size(); }
+  const Event& front() override { return (*mBuffer)[mPosition]; }
+  void pop() override { ++mPosition; }
+
+private:
+  TraceBufferPtr mBuffer;
+  size_t mPosition = 0;
+};
@@ -0,0 +1,269 @@
+#include "trace-cursor.h"
+
+#include <cstring>
+#include <math.h>
+#include <sys/stat.h>
+
+#include "field-scanner.h"
+#include "trace-index.h"
+#include "columnar-trace.h"
+#include "parallel-trace-cursor.h"
+#include "gzip-trace-cursor.h"
+#include "decimating-trace-cursor.h"
+
+TraceFileCursor::TraceFileCursor(const std::string &location)
+  : mLocation(location)
+  , mTrace(location)
+{
+  assert(mTrace.isOpen());
+
+  // first line dummy
+  const char *lineEnd = static_cast<const char*>(memchr(mTrace.data(), '\n', mTrace.size()));
+  mReadOffset = lineEnd ? lineEnd - mTrace.data() + 1 : mTrace.size();
+}
+
+bool TraceFileCursor::empty()
+{
+  if (!mHasFront)
+    refill();
+  return !mHasFront;
+}
+
+const Event &TraceFileCursor::front()
+{
+  if (!mHasFront)
+    refill();
+  assert(mHasFront);
+  return mFront;
+}
+
+void TraceFileCursor::pop()
+{
+  assert(mHasFront);
+  mHasFront = false;
+}
+
+void TraceFileCursor::refill()
+{
+  const char *data = mTrace.data();
+  const uint64_t size = mTrace.size();
+  while (!mHasFront && mReadOffset < size)
+    {
+      const char *begin = data + mReadOffset;
+      const char *end = static_cast<const char*>(memchr(begin, '\n', size - mReadOffset));
+      if (!end)
+        end = data + size;
+
+      mFrontOffset = mReadOffset;
+      mFrontLineNumber = mReadLineNumber++;
+      mReadOffset = end - data + 1;
+      mHasFront = parseLine(begin, end, mFrontLineNumber, mFront);
+    }
+}
+
+void TraceFileCursor::seek(Time from)
+{
+  TraceIndex index(mLocation);
+  if (!index.load())
+    {
+      LOG("indexing " << mLocation);
+      for (; !empty(); pop())
+        index.add(front().atTime, mFrontOffset, mFrontLineNumber);
+      if (!index.save())
+        WARN("trace index cannot be saved, it is built again on the next run");
+    }
+
+  const TraceIndex::Entry entry = index.entryOf(from);
+  mReadOffset = entry.offset;
+  mReadLineNumber = entry.lineNumber;
+  mHasFront = false;
+
+  while (!empty() && front().atTime < from)
+    pop();
+}
+
+
+LineParse RlcTraceCursor::parse(const char *begin, const char *end, RlcRecord &record)
+{
+  if (end - begin < 15)
+    return LineParse::broken;
+
+  FieldScanner fields(begin, end);
+  /*
+   *  % start end CellId IMSI RNTI LCID nTxPDUs TxBytes nRxPDUs RxBytes delay ... etc
+   */
+  double timeBegin; // seconds
+  double timeEnd; // seconds
+  int lcid, nTxPdu, nRxPdu;
+
+  if (!(fields.next(timeBegin) && fields.next(timeEnd) && fields.next(record.cellId) && fields.next(record.imsi)
+        && fields.next(record.rnti) && fields.next(lcid) && fields.next(nTxPdu) && fields.next(record.txBytes)
+        && fields.next(nRxPdu) && fields.next(record.rxBytes)))
+    return LineParse::broken;
+  if (record.cellId > 3)
+    return LineParse::filtered;
+
+//  assert((nTxPdu == 1 || nTxPdu == 0) && (nRxPdu == 0 || nRxPdu == 1));
+  record.startTime = static_cast<uint64_t>(round(timeBegin * 1000) * 1000);
+  record.endTime = static_cast<uint64_t>(round(timeEnd * 1000) * 1000);
+  return LineParse::event;
+}
+
+void RlcTraceCursor::warnBroken(const char *begin, const char *end)
+{
+  WARN("drop line: " << std::string(begin, end));
+}
+
+Event eventOf(const RlcRecord &record, uint64_t lineNumber)
+{
+  DlRlcPacket packet;
+  packet.index = lineNumber;
+  packet.endTime = record.endTime;
+  packet.rxBytes = record.rxBytes;
+  packet.imsi = record.imsi;
+
+  Event event(EventType::scheduleAttempt, record.startTime);
+  event.cellId = record.cellId;
+  event.packet = packet;
+  return event;
+}
+
+bool RlcTraceCursor::parseLine(const char *begin, const char *end, uint64_t lineNumber, Event &event)
+{
+  return parseEvent<RlcTraceCursor>(begin, end, lineNumber, event);
+}
+
+
+LineParse MeasurementsTraceCursor::parse(const char *begin, const char *end, MeasurementRecord &record)
+{
+  if (end - begin < 7)
+    return LineParse::broken;
+
+  FieldScanner fields(begin, end);
+  if (!(fields.next(record.time) && fields.next(record.sourceCellId) && fields.next(record.targetCellId)
+        && fields.next(record.rsrp)))
+    return LineParse::broken;
+  if (record.sourceCellId > 3 || record.targetCellId > 3)
+    return LineParse::filtered;
+  return LineParse::event;
+}
+
+void MeasurementsTraceCursor::warnBroken(const char *begin, const char *end)
+{
+  WARN("warn: drop line: \"" << std::string(begin, end) << "\"");
+}
+
+Event eventOf(const MeasurementRecord &record, uint64_t)
+{
+  CSIMeasurementReport report;
+  report.targetCellId = record.targetCellId;
+  report.csi = {record.time, record.rsrp};
+
+  Event event(EventType::csiIndicator, record.time);
+  event.cellId = record.sourceCellId;
+  event.report = report;
+  return event;
+}
+
+bool MeasurementsTraceCursor::parseLine(const char *begin, const char *end, uint64_t lineNumber, Event &event)
+{
+  return parseEvent<MeasurementsTraceCursor>(begin, end, lineNumber, event);
+}
+
+
+namespace
+{
+  UniqTraceCursor openStoredTrace(const std::string &location, TraceKind kind, Time from, size_t parseThreads)
+  {
+    std::unique_ptr<ColumnarTraceCursor> columnar(new ColumnarTraceCursor(ColumnarTrace::locationOf(location), kind));
+    if (columnar->isValid())
+      {
+        if (!columnar->isConvertedFrom(location))
+          {
+            WARN(ColumnarTrace::locationOf(location) << " is not converted from the current trace, the text is parsed");
+          }
+        else
+          {
+            LOG("reading " << ColumnarTrace::locationOf(location));
+            if (from)
+              columnar->seek(from);
+            return UniqTraceCursor(std::move(columnar));
+          }
+      }
+
+    // the compressed copy is read if the text trace is not unpacked
+    struct stat info;
+    if (stat(location.c_str(), &info) != 0 && stat(GzipTraceCursor::locationOf(location).c_str(), &info) == 0)
+      return UniqTraceCursor(new GzipTraceCursor(GzipTraceCursor::locationOf(location), kind, from));
+
+    if (parseThreads > 1)
+      return UniqTraceCursor(new ParallelTraceCursor(location, kind, parseThreads, from));
+
+    std::unique_ptr<TraceFileCursor> text;
+    if (kind == TraceKind::rlcStats)
+      text.reset(new RlcTraceCursor(location));
+    else
+      text.reset(new MeasurementsTraceCursor(location));
+    if (from)
+      text->seek(from);
+    return UniqTraceCursor(std::move(text));
+  }
+}
+
+UniqTraceCursor openTrace(const std::string &location, TraceKind kind, Time from, size_t parseThreads)
+{
+  UniqTraceCursor trace = openStoredTrace(location, kind, from, parseThreads);
+  // the RLC stream is the same for every reporting period
+  if (kind == TraceKind::measurements)
+    return DecimatingTraceCursor::decimate(std::move(trace));
+  return trace;
+}
+
+
+std::unique_ptr<MergedTraceCursor> MergedTraceCursor::openScenario(const std::string &inputDir, Time from,
+                                                                   size_t parseThreads)
+{
+  // the same order as preloaded traces have
+  std::unique_ptr<MergedTraceCursor> traces(new MergedTraceCursor);
+  traces->add(openTrace(inputDir + "/DlRlcStats.txt", TraceKind::rlcStats, from, parseThreads));
+  traces->add(openTrace(inputDir + "/measurements.log", TraceKind::measurements, from, parseThreads));
+  return traces;
+}
+
+void MergedTraceCursor::add(UniqTraceCursor cursor)
+{
+  mCursors.push_back(std::move(cursor));
+}
+
+bool MergedTraceCursor::empty()
+{
+  return !earliest();
+}
+
+const Event &MergedTraceCursor::front()
+{
+  ITraceCursor *cursor = earliest();
+  assert(cursor);
+  return cursor->front();
+}
+
+void MergedTraceCursor::pop()
+{
+  ITraceCursor *cursor = earliest();
+  assert(cursor);
+  cursor->pop();
+  mFront = nullptr;
+}
+
+ITraceCursor *MergedTraceCursor::earliest()
+{
+  if (mFront)
+    return mFront;
+
+  for (auto &cursor : mCursors)
+    {
+      if (!cursor->empty() && (!mFront || cursor->front().atTime < mFront->front().atTime))
+        mFront = cursor.get();
+    }
+  return mFront;
+}
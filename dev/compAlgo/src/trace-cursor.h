@@ -0,0 +1,177 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "helpers.h"
+#include "mapped-file.h"
+
+//! @class ITraceCursor is a time-ordered stream of trace events
+class ITraceCursor
+{
+public:
+  virtual ~ITraceCursor() = default;
+
+  virtual bool empty() = 0;
+  virtual const Event& front() = 0;
+  virtual void pop() = 0;
+};
+
+using UniqTraceCursor = std::unique_ptr<ITraceCursor>;
+
+
+enum class TraceKind : uint32_t
+{
+  rlcStats,     //< DlRlcStats.txt
+  measurements  //< measurements.log
+};
+
+//! @brief what the parsers make of a trace line
+enum class LineParse
+{
+  event,     //< the line makes an event
+  filtered,  //< the line is not of the simulated cells
+  broken     //< the line is short or malformed, it is warned about
+};
+
+//! @brief fields of one DlRlcStats.txt line the simulation and the columnar traces use
+struct RlcRecord
+{
+  Time startTime;
+  Time endTime;
+  int cellId;
+  int imsi;
+  int rnti;
+  int txBytes;
+  int rxBytes;
+};
+
+//! @brief fields of one measurements.log line
+struct MeasurementRecord
+{
+  Time time;
+  int sourceCellId;
+  int targetCellId;
+  int rsrp;
+};
+
+//! @brief cursor of the trace, from its columnar copy "<trace>.col" if there is an up-to-date one,
+//!  from its compressed copy "<trace>.gz" if there is no text trace
+//! @arg from time of the first event, earlier ones are skipped
+//! @arg parseThreads more than one parses the whole text trace at once by ParallelTraceCursor,
+//!  for the runs that take all of it before the simulation
+UniqTraceCursor openTrace(const std::string &location, TraceKind kind, Time from = 0, size_t parseThreads = 1);
+
+
+//! @class TraceFileCursor reads a time-ordered trace file lazily, one event at a time
+//! @brief the file is mapped into the memory and the lines are parsed in place
+class TraceFileCursor : public ITraceCursor
+{
+public:
+  TraceFileCursor(const std::string &location);
+
+  bool empty() override;
+  const Event& front() override;
+  void pop() override;
+
+  //! @brief skips to the first event at or after the time through the sidecar TraceIndex,
+  //!  the index is built on the first seek in the trace
+  void seek(Time from);
+
+protected:
+  //! @arg begin, end the line without the line break
+  //! @arg lineNumber of the line after the header
+  //! @return false if the line must be dropped
+  virtual bool parseLine(const char *begin, const char *end, uint64_t lineNumber, Event &event) = 0;
+
+private:
+  const std::string mLocation;
+  MappedFile mTrace;
+  uint64_t mReadOffset = 0;      //< of the next line to read
+  uint64_t mReadLineNumber = 0;  //< of the next line to read
+  uint64_t mFrontOffset = 0;     //< of the front event line
+  uint64_t mFrontLineNumber = 0; //< of the front event line
+  Event mFront;
+  bool mHasFront = false;
+
+  TraceFileCursor(const TraceFileCursor &) = delete;
+  TraceFileCursor& operator =(const TraceFileCursor &) = delete;
+
+  void refill();
+};
+
+
+//! @class RlcTraceCursor makes EventType::scheduleAttempt from DlRlcStats.txt
+class RlcTraceCursor : public TraceFileCursor
+{
+public:
+  RlcTraceCursor(const std::string &location) : TraceFileCursor(location) {}
+
+  using Record = RlcRecord;
+  static LineParse parse(const char *begin, const char *end, RlcRecord &record);
+  static void warnBroken(const char *begin, const char *end);
+
+protected:
+  bool parseLine(const char *begin, const char *end, uint64_t lineNumber, Event &event) override;
+};
+
+
+//! @class MeasurementsTraceCursor makes EventType::csiIndicator from measurements.log
+class MeasurementsTraceCursor : public TraceFileCursor
+{
+public:
+  MeasurementsTraceCursor(const std::string &location) : TraceFileCursor(location) {}
+
+  using Record = MeasurementRecord;
+  static LineParse parse(const char *begin, const char *end, MeasurementRecord &record);
+  static void warnBroken(const char *begin, const char *end);
+
+protected:
+  bool parseLine(const char *begin, const char *end, uint64_t lineNumber, Event &event) override;
+};
+
+
+//! @brief event of a parsed line, the text, parallel, gzip and columnar cursors make them all here
+//! @arg lineNumber of the line after the header, becomes DlRlcPacket::index
+Event eventOf(const RlcRecord &record, uint64_t lineNumber);
+Event eventOf(const MeasurementRecord &record, uint64_t lineNumber = 0);
+
+//! @brief parses the line by Parser::parse and makes its event, the broken lines are warned about
+//! @return false if the line must be dropped
+template <typename Parser>
+bool parseEvent(const char *begin, const char *end, uint64_t lineNumber, Event &event)
+{
+  typename Parser::Record record;
+  const LineParse result = Parser::parse(begin, end, record);
+  if (result == LineParse::broken)
+    Parser::warnBroken(begin, end);
+  if (result != LineParse::event)
+    return false;
+
+  event = eventOf(record, lineNumber);
+  return true;
+}
+
+
+//! @class MergedTraceCursor merges several cursors by time
+//! @brief on equal time the cursor added earlier goes first
+class MergedTraceCursor : public ITraceCursor
+{
+public:
+  //! @brief RLC and measurements traces of the scenario directory, on equal time RLC goes first
+  //! @arg from, parseThreads see openTrace
+  static std::unique_ptr<MergedTraceCursor> openScenario(const std::string &inputDir, Time from = 0,
+                                                         size_t parseThreads = 1);
+
+  void add(UniqTraceCursor cursor);
+
+  bool empty() override;
+  const Event& front() override;
+  void pop() override;
+
+private:
+  std::vector<UniqTraceCursor> mCursors;
+  ITraceCursor *mFront = nullptr;
+
+  ITraceCursor* earliest();
+};
@@ -0,0 +1,59 @@
+#include "trace-fingerprint.h"
+
+#include <vector>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+namespace
+{
+  //! @brief FNV-1a
+  uint64_t hashOf(const char *data, size_t size, uint64_t hash)
+  {
+    for (size_t i = 0; i < size; i++)
+      hash = (hash ^ static_cast<unsigned char>(data[i])) * 1099511628211ull;
+    return hash;
+  }
+
+  bool readAt(int fd, uint64_t offset, std::vector<char> &block)
+  {
+    size_t done = 0;
+    while (done < block.size())
+      {
+        const ssize_t size = pread(fd, block.data() + done, block.size() - done, offset + done);
+        if (size <= 0)
+          return false;
+        done += size;
+      }
+    return true;
+  }
+}
+
+constexpr size_t TraceFingerprint::hashedSize;
+
+bool TraceFingerprint::of(const std::string &location, TraceFingerprint &fingerprint)
+{
+  const int fd = open(location.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+
+  struct stat info;
+  bool isRead = fstat(fd, &info) == 0;
+  if (isRead)
+    {
+      fingerprint.size = info.st_size;
+      fingerprint.modifiedTime = int64_t(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec;
+      fingerprint.hash = 14695981039346656037ull;
+
+      // the tail does not overlap the head in a short trace
+      std::vector<char> block(std::min<uint64_t>(fingerprint.size, hashedSize));
+      isRead = readAt(fd, 0, block);
+      fingerprint.hash = hashOf(block.data(), block.size(), fingerprint.hash);
+      block.resize(std::min<uint64_t>(fingerprint.size - block.size(), hashedSize));
+      isRead = isRead && readAt(fd, fingerprint.size - block.size(), block);
+      fingerprint.hash = hashOf(block.data(), block.size(), fingerprint.hash);
+    }
+  close(fd);
+  return isRead;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+//! @struct TraceFingerprint tells whether a sidecar file (index, columnar copy) is made of the current trace
+//! @brief the size, the modification time and a hash of the first and the last hashedSize bytes:
+//!  an edit which keeps the size is caught by the time, a copy of another trace by the hash
+struct TraceFingerprint
+{
+  static constexpr size_t hashedSize = 64 * 1024;
+
+  uint64_t size = 0;
+  int64_t modifiedTime = 0; //< [ns] since the epoch
+  uint64_t hash = 0;
+
+  //! @return false if the trace cannot be read
+  static bool of(const std::string &location, TraceFingerprint &fingerprint);
+
+  bool operator ==(const TraceFingerprint &other) const
+  {
+    return size == other.size && modifiedTime == other.modifiedTime && hash == other.hash;
+  }
+  bool operator !=(const TraceFingerprint &other) const { return !(*this == other); }
+};
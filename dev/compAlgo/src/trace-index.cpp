@@ -0,0 +1,84 @@
+#include "trace-index.h"
+
+#include <fstream>
+#include <algorithm>
+
+namespace
+{
+  const char *const indexSignature = "compAlgo trace index";
+  const uint32_t indexVersion = 3;
+}
+
+constexpr Time TraceIndex::indexStep;
+
+TraceIndex::TraceIndex(const std::string &traceLocation)
+  : mTraceLocation(traceLocation)
+{
+  const bool isRead = TraceFingerprint::of(traceLocation, mTrace);
+  assert(isRead);
+  UNUSED(isRead);
+}
+
+bool TraceIndex::load()
+{
+  std::fstream file(location(), std::ios_base::in | std::ios_base::binary);
+  if (!file.is_open())
+    return false;
+
+  CheckpointReader reader(file);
+  std::string signature;
+  uint32_t version = 0;
+  TraceFingerprint trace;
+  Time step = 0;
+  reader.read(signature);
+  reader.read(version);
+  reader.read(trace.size);
+  reader.read(trace.modifiedTime);
+  reader.read(trace.hash);
+  reader.read(step);
+  if (!reader.good() || signature != indexSignature || version != indexVersion
+      || trace != mTrace || step != indexStep)
+    return false;
+
+  reader.read(mEntries);
+  // the offsets are seeked to, a broken index is built again
+  return reader.good() && std::all_of(mEntries.begin(), mEntries.end(),
+                                      [this](const Entry &entry) { return entry.offset <= mTrace.size; });
+}
+
+bool TraceIndex::save() const
+{
+  std::fstream file(location(), std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+  if (!file.is_open())
+    return false;
+
+  CheckpointWriter writer(file);
+  writer.write(std::string(indexSignature));
+  writer.write(indexVersion);
+  writer.write(mTrace.size);
+  writer.write(mTrace.modifiedTime);
+  writer.write(mTrace.hash);
+  writer.write(indexStep);
+  writer.write(mEntries);
+  file.flush();
+  return writer.good();
+}
+
+void TraceIndex::add(Time time, uint64_t offset, uint64_t lineNumber)
+{
+  if (mEntries.empty() || time / indexStep > mEntries.back().time / indexStep)
+    mEntries.push_back({time, offset, lineNumber});
+}
+
+TraceIndex::Entry TraceIndex::entryOf(Time time) const
+{
+  if (mEntries.empty())
+    return {time, mTrace.size, 0};
+
+  // the last entry not later than the time, the events of its step before the time are skipped by reading
+  auto entry = std::upper_bound(mEntries.begin(), mEntries.end(), time,
+                                [](Time t, const Entry &e) { return t < e.time; });
+  if (entry != mEntries.begin())
+    --entry;
+  return *entry;
+}
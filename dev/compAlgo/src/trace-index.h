@@ -0,0 +1,43 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "helpers.h"
+#include "trace-fingerprint.h"
+
+//! @class TraceIndex maps the time to the byte offset of a time-ordered trace file
+//! @brief keeps the first event of every indexStep of the trace time with the offset and number of its line.
+//!  It is saved next to the trace as "<trace>.idx" and built again if the TraceFingerprint of the trace changes.
+class TraceIndex
+{
+public:
+  static constexpr Time indexStep = Converter::milliseconds(10);
+
+  struct Entry
+  {
+    Time time;
+    uint64_t offset;
+    uint64_t lineNumber; //< after the header
+  };
+
+  TraceIndex(const std::string &traceLocation);
+
+  //! @return false if there is no index of the current trace
+  bool load();
+  //! @return false if the index cannot be written, e.g. the input directory is read-only
+  bool save() const;
+
+  //! @brief events are added in the trace order
+  void add(Time time, uint64_t offset, uint64_t lineNumber);
+
+  //! @return a line at or before the first event at or after the time
+  Entry entryOf(Time time) const;
+
+private:
+  const std::string mTraceLocation;
+  TraceFingerprint mTrace;
+  std::vector<Entry> mEntries;
+
+  std::string location() const { return mTraceLocation + ".idx"; }
+};
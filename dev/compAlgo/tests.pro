@@ -0,0 +1,34 @@
+TEMPLATE = app
+TARGET = compAlgo-tests
+CONFIG += console
+CONFIG -= app_bundle
+CONFIG -= qt
+
+QMAKE_CXXFLAGS += -std=c++11
+
+LIBS += -pthread
+
+CONFIG(debug, debug | release) {
+	CONFIGURATION = debug
+} else {
+	CONFIGURATION = release
+}
+
+OBJECTS_DIR = $$PWD/build/$$CONFIGURATION/tests/obj
+MOC_DIR = $$PWD/build/$$CONFIGURATION/tests/moc
+DESTDIR = $$PWD/build/$$CONFIGURATION/bin/
+
+SOURCES += src/tests/tests.cpp \
+    src/tests/checkpoint-test.cpp \
+    src/tests/event-queue-test.cpp \
+    src/tests/field-scanner-test.cpp \
+    src/helpers.cpp \
+    src/event-queue.cpp \
+    src/field-scanner.cpp
+
+HEADERS += \
+    src/tests/tests.h \
+    src/helpers.h \
+    src/checkpoint.h \
+    src/event-queue.h \
+    src/field-scanner.h
@@ -3,6 +3,7 @@
 # author: Ivan Senin 
 import sys
 import re
+import subprocess
 import numpy as np
 import matplotlib.pyplot as plt
 
@@ -71,6 +72,34 @@ def load_measurements(filepath, used_to_same_cell_id=False):
 
 	return timings, measurements
 
+def load_series(filepath, used_to_same_cell_id=False, may_rm_outliers=False, may_smooth=False, xrange=None):
+	# the native reducer rejects the outliers, smooths and keeps the min/max of every pixel column of xrange
+	series_path = filepath + ".series"
+	args = ["compAlgo/build/release/bin/rsrp-reduce", filepath, series_path]
+	if may_rm_outliers:
+		args.append("--rm-outliers")
+	if may_smooth:
+		args.append("--smooth")
+	if used_to_same_cell_id:
+		args.append("--same-cell")
+	if xrange:
+		args += ["--range", str(xrange[0]), str(xrange[1])]
+	subprocess.check_call(args)
+	series_data = np.loadtxt(series_path, comments = '%', ndmin = 2)
+	# % 0series	1time[s]	2RSRP
+
+	timings = { 1 : [], 2 : [], 3 : [], 11 : [], 12 : [], 13 : []}
+	measurements = { 1 : [], 2 : [], 3 : [], 11 : [], 12 : [], 13 : []}
+
+	for i in range(series_data.shape[0]):
+		idx = int(series_data[i, 0])
+		if idx not in timings:
+			continue
+		timings[idx].append(series_data[i, 1])
+		measurements[idx].append(series_data[i, 2])
+
+	return timings, measurements
+
 def find_bounds(measurements):
 	rmin = +float('Inf')
 	rmax = -float('Inf')
@@ -81,12 +110,17 @@ def find_bounds(measurements):
 		rmax = max(rmax, imax)
 	return rmin, rmax
 
-def plot_comp_ue_measures(may_rm_outliers=False):
-	timing, measurement = load_measurements("compAlgo/output/measurements.log", used_to_same_cell_id=True)
+def plot_comp_ue_measures(may_rm_outliers=False, reduced=False, xrange=None):
+	filepath = "compAlgo/output/measurements.log"
+	if reduced:
+		timing, measurement = load_series(filepath, used_to_same_cell_id=True, may_rm_outliers=may_rm_outliers,
+			xrange=xrange)
+	else:
+		timing, measurement = load_measurements(filepath, used_to_same_cell_id=True)
 	timing = timing[1]
 	measurement = measurement[1]
 
-	if may_rm_outliers:
+	if may_rm_outliers and not reduced:
 		timing, measurement = reject_outliers(timing, measurement)
 
 	plt.plot(timing, measurement, 'k--', label='Ue', linewidth=3.9)
@@ -113,20 +147,23 @@ def smooth(xs, ys):
 	return xs, y_smooth
 
 
-def main():
-	if "--nope" in sys.argv:
-		exit()
-
-	filepath = "compAlgo/input/measurements.log"
-	if "--scores" in sys.argv:
-		filepath = "compAlgo/output/moving_score.log"
-	timings, measurements = load_measurements(filepath)
+def plot_lines(filepath, reduced, xrange=None):
+	may_rm_outliers = "--rm-outliers" in sys.argv
+	may_smooth = "--smooth" in sys.argv
+	if reduced:
+		timings, measurements = load_series(filepath, may_rm_outliers=may_rm_outliers, may_smooth=may_smooth,
+			xrange=xrange)
+	else:
+		timings, measurements = load_measurements(filepath)
 
 	if "--row" in sys.argv:
-		plot_as_is(timings, measurements, 0.1)
+		# the raw series, before the outliers are rejected
+		if reduced and (may_rm_outliers or may_smooth):
+			plot_as_is(*load_series(filepath, xrange=xrange), lw_offset=0.1)
+		else:
+			plot_as_is(timings, measurements, 0.1)
 
-	may_rm_outliers = "--rm-outliers" in sys.argv
-	if may_rm_outliers:
+	if may_rm_outliers and not reduced:
 		for i in range(1,4):
 			timings[i], measurements[i] = reject_outliers(timings[i], measurements[i])
 
@@ -139,7 +176,7 @@ def main():
 			measurements[i] = spline(timings[i], measurements[i], xnew[i])
 		timings = xnew"""
 
-	if "--smooth" in sys.argv:
+	if may_smooth and not reduced:
 		timings[1], measurements[1] = smooth(timings[1], measurements[1])
 		timings[2], measurements[2] = smooth(timings[2], measurements[2])
 		timings[3], measurements[3] = smooth(timings[3], measurements[3])
@@ -147,7 +184,27 @@ def main():
 	plot_as_is(timings, measurements)
 
 	if "--ue" in sys.argv:
-		plot_comp_ue_measures(may_rm_outliers)
+		plot_comp_ue_measures(may_rm_outliers, reduced, xrange)
+
+	return timings, measurements
+
+def replot_lines(filepath, reduced, xrange):
+	# a reduction of the whole trace is too sparse for a zoomed view, the lines are reduced again for it
+	if not reduced:
+		return
+	for line in list(plt.gca().get_lines()):
+		line.remove()
+	plot_lines(filepath, reduced, xrange)
+
+def main():
+	if "--nope" in sys.argv:
+		exit()
+
+	filepath = "compAlgo/input/measurements.log"
+	if "--scores" in sys.argv:
+		filepath = "compAlgo/output/moving_score.log"
+	reduced = "--reduced" in sys.argv
+	timings, measurements = plot_lines(filepath, reduced)
 
 	mmin, mmax = find_bounds(measurements)
 	ydelta = abs(float(mmax - mmin) / 10.0)
@@ -155,7 +212,7 @@ def main():
 	xmin, xmax = find_bounds(timings)
 	xdelta = abs(float(xmin - xmax) / 30.0)
 
-	
+	replot_lines(filepath, reduced, (1.15, 2.15))
 	plt.legend(loc=4, prop={'size': 22})
 	plt.grid(True)
 	plt.xlabel('Time [s]', fontsize=18)
@@ -170,21 +227,25 @@ def main():
 
 	plt.tight_layout()
 
+	replot_lines(filepath, reduced, (1.90, 2.15))
 	plt.legend(loc=0)
 	plt.xlim((1.90, 2.15))
 	plt.ylim((52, 67.5))
 	plt.savefig("_viewPoint4.png", dpi = 200, bbox_inches='tight')
 
+	replot_lines(filepath, reduced, (2.5, 2.62))
 	plt.legend(loc='lower right')
 	plt.xlim((2.5, 2.62))
 	plt.ylim((50, 70))
 	plt.savefig("_viewPoint5.png", dpi = 200, bbox_inches='tight')
 
+	replot_lines(filepath, reduced, (12.7, 13.05))
 	plt.legend(loc=0)
 	plt.xlim((12.7, 13.05))
 	plt.ylim((52.3, 66.2))
 	plt.savefig("_viewPoint6.png", dpi = 200, bbox_inches='tight')
 
+	replot_lines(filepath, reduced, None)
 	plt.legend(loc=0)
 	plt.xlim((xmin - xdelta, xmax + xdelta))
 	plt.ylim((mmin - ydelta, mmax + ydelta))
@@ -16,6 +16,8 @@ fi
 cd compAlgo
 echo "Compiling CoMP simulation app"
 qmake DEFINES+="NDEBUG" && make -j4 --quiet || exit 1
+qmake throughput-calc.pro -o Makefile.throughput-calc DEFINES+="NDEBUG" && make -f Makefile.throughput-calc -j4 --quiet || exit 1
+qmake rsrp-reduce.pro -o Makefile.rsrp-reduce DEFINES+="NDEBUG" && make -f Makefile.rsrp-reduce -j4 --quiet || exit 1
 echo "" && echo ""
 
 ./build/release/bin/compAlgo || (echo "Simulation failed" && exit)
@@ -23,17 +25,19 @@ cd ..
 
 echo ""
 echo "Undetermined results:"
-python throughputCalc.py compAlgo/input/DlRlcStats.txt
+compAlgo/build/release/bin/throughput-calc compAlgo/input/DlRlcStats.txt
 
 echo "CoMP algo:"
-python throughputCalc.py compAlgo/output/DlRlcStats.txt --ignore-imsi
+compAlgo/build/release/bin/throughput-calc compAlgo/output/DlRlcStats.txt --ignore-imsi
 echo ""
 
-python plotRsrp.py --ue $1
+python plotRsrp.py --reduced --ue $1
 echo "Measurements plot done. See 'measurements_plot.png'"
 echo "Postprocessing finished"
 
 cd compAlgo
 make --quiet clean
+make -f Makefile.throughput-calc --quiet clean
+make -f Makefile.rsrp-reduce --quiet clean
 echo "Simulation finished"
 